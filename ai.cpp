@@ -1,47 +1,72 @@
 #include <algorithm>
 #include <chrono>
 #include <limits>
-#include <random>
 #include <vector>
 
 #include "ai.hpp"
 
 namespace AI {
 
-    static std::mt19937 rng(0);
-
     unsigned int grid_distance(Simulator::Position t_p1, Simulator::Position t_p2);
 
-    Simulator::Direction random_player(const Simulator::Board& t_board, const std::string& t_playerId) {
-        return DIRECTIONS_MAP[rng() % DIRECTIONS_MAP.size()];
+    // Moves of every 4 bit move mask in Direction order, and how many there are
+    constexpr std::array<std::array<Simulator::Direction, 4>, 16> generate_mask_moves() {
+        std::array<std::array<Simulator::Direction, 4>, 16> result{};
+        for (unsigned int mask = 0; mask < 16; mask++) {
+            unsigned int count = 0;
+            for (unsigned int i = 0; i < 4; i++) {
+                if ((mask >> i) & 1) {
+                    result[mask][count++] = DIRECTIONS_MAP[i];
+                }
+            }
+        }
+        return result;
+    }
+
+    constexpr std::array<std::array<Simulator::Direction, 4>, 16> MASK_MOVES = generate_mask_moves();
+    constexpr std::array<uint8_t, 16> MASK_MOVE_COUNTS {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+    constexpr unsigned int move_bit(Simulator::Direction t_move) {
+        return 1u << static_cast<unsigned int>(t_move);
+    }
+
+    // Uniformly random move of t_mask, the first direction if t_mask is empty
+    Simulator::Direction random_move(unsigned int t_mask, Simulator::Rng& t_rng) {
+        if (t_mask == 0) {
+            return DIRECTIONS_MAP[0];
+        }
+        return MASK_MOVES[t_mask][t_rng.below(MASK_MOVE_COUNTS[t_mask])];
+    }
+
+    Simulator::Direction random_player(const Simulator::Board& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng) {
+        return DIRECTIONS_MAP[t_rng.below(DIRECTIONS_MAP.size())];
     }
 
-    Simulator::Direction avoid_walls_player(const Simulator::Board& t_board, const std::string& t_playerId) {
-        const std::vector<Simulator::Direction> possibleMoves = get_safe_moves(t_board, t_playerId);
+    Simulator::Direction avoid_walls_player(const Simulator::Board& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng) {
+        const std::vector<Simulator::Direction> possibleMoves = get_safe_moves(t_board, t_playerIndex);
         
-        //std::cout << t_playerId << ": ";
+        //std::cout << t_playerIndex << ": ";
         //for (const auto move : possibleMoves) {
         //    std::cout << Simulator::direction_to_string(move) << ' ';
         //}
         //std::cout << '\n';
 
         if (!possibleMoves.empty()) {
-            return possibleMoves[rng() % possibleMoves.size()];
+            return possibleMoves[t_rng.below(possibleMoves.size())];
         }
         else {
             return DIRECTIONS_MAP[0];
         }
     }
 
-    Simulator::Direction seek_food_player(const Simulator::Board& t_board, const std::string& t_playerId) {
-        if (!t_board.is_valid_id(t_playerId)) {
+    Simulator::Direction seek_food_player(const Simulator::Board& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng) {
+        if (!t_board.is_alive(t_playerIndex)) {
             return Simulator::Direction::UP; // TODO: change this
         }
 
-        const std::vector<Simulator::Direction> possibleMoves = get_safe_moves(t_board, t_playerId);
+        const std::vector<Simulator::Direction> possibleMoves = get_safe_moves(t_board, t_playerIndex);
 
-        const Simulator::Snake& snake = t_board.get_snake(t_playerId);
-        const Simulator::FoodGrid& food = t_board.get_food();
+        const Simulator::Snake& snake = t_board.get_snake(t_playerIndex);
         const Simulator::Position head = snake.get_head();
         const Simulator::Ruleset ruleset = t_board.get_ruleset();
         
@@ -52,7 +77,7 @@ namespace AI {
                 const Simulator::Position pos = Simulator::Position{x, y};
                 const unsigned int distance = grid_distance(pos, head);
                 
-                if (food.cells(x, y) &&  distance < closestFoodDistance) {
+                if (t_board.has_food(pos) && distance < closestFoodDistance) {
                     closestFood = pos;
                     closestFoodDistance = distance;
                 }
@@ -71,10 +96,10 @@ namespace AI {
         seekingMoves.erase(eraseIt, seekingMoves.end());
 
         if (!seekingMoves.empty()) {
-            return seekingMoves[rng() % seekingMoves.size()];
+            return seekingMoves[t_rng.below(seekingMoves.size())];
         }
         else if (!possibleMoves.empty()) {
-            return possibleMoves[rng() % possibleMoves.size()];
+            return possibleMoves[t_rng.below(possibleMoves.size())];
         }
         else {
             return DIRECTIONS_MAP[0];
@@ -82,20 +107,111 @@ namespace AI {
         
     }
 
-    std::vector<Simulator::Direction> get_safe_moves(const Simulator::Board& t_board, const std::string& t_playerId) {
-        if (!t_board.is_valid_id(t_playerId)) {
+    template <class Geometry>
+    Simulator::Direction avoid_walls_player(const Simulator::BasicBitBoard<Geometry>& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng) {
+        return random_move(t_board.get_safe_move_mask(t_playerIndex), t_rng);
+    }
+
+    template <class Geometry>
+    Simulator::Direction seek_food_player(const Simulator::BasicBitBoard<Geometry>& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng) {
+        const unsigned int safeMoves = t_board.get_safe_move_mask(t_playerIndex);
+        if (safeMoves == 0) {
+            return DIRECTIONS_MAP[0];
+        }
+
+        // The moves that get closer to the closest food are the ones towards it on either axis
+        const Simulator::Position head = t_board.get_head(t_playerIndex);
+        const std::optional<Simulator::Position> closestFood = t_board.get_closest_food(head);
+
+        unsigned int seekingMoves = 0;
+        if (closestFood) {
+            if (closestFood->y < head.y) seekingMoves |= move_bit(Simulator::Direction::UP);
+            if (closestFood->y > head.y) seekingMoves |= move_bit(Simulator::Direction::DOWN);
+            if (closestFood->x < head.x) seekingMoves |= move_bit(Simulator::Direction::LEFT);
+            if (closestFood->x > head.x) seekingMoves |= move_bit(Simulator::Direction::RIGHT);
+        }
+        seekingMoves &= safeMoves;
+
+        return random_move((seekingMoves != 0) ? seekingMoves : safeMoves, t_rng);
+    }
+
+    template <class Geometry>
+    unsigned int rollout_turn(Simulator::BasicBitBoard<Geometry>& t_board, Simulator::Rng& t_rng) {
+        static constexpr std::array<Simulator::Direction (*)(const Simulator::BasicBitBoard<Geometry>&, unsigned int, Simulator::Rng&), 2> STRATEGIES {
+            avoid_walls_player,
+            seek_food_player
+        };
+
+        unsigned int moved = 0;
+        Simulator::MoveArray moves{};
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (t_board.is_alive(i)) {
+                const auto strategy = STRATEGIES[t_rng.below(STRATEGIES.size())];
+                moves[i] = strategy(t_board, i, t_rng);
+                moved++;
+            }
+        }
+        t_board.update(moves);
+
+        return moved;
+    }
+
+    template <class Geometry>
+    RewardArray heuristic_evaluate(const Simulator::BasicBitBoard<Geometry>& t_board, HeuristicWeights t_weights) {
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        const Simulator::Territory territory = t_board.get_territory();
+
+        unsigned int totalSpace = 0;
+        unsigned int totalLength = 0;
+        unsigned int aliveCount = 0;
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (!t_board.is_alive(i)) continue;
+
+            aliveCount++;
+            totalSpace += territory.owned[i];
+            totalLength += t_board.get_length(i);
+        }
+
+        const float totalWeight = t_weights.space + t_weights.length + t_weights.health;
+
+        RewardArray result{};
+        if (!(totalWeight > 0.0f)) {
+            // Nothing tells the snakes apart, so they get equal shares
+            for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+                if (t_board.is_alive(i)) {
+                    result[i] = 1.0f / static_cast<float>(aliveCount);
+                }
+            }
+            return result;
+        }
+
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (!t_board.is_alive(i)) continue;
+
+            const float spaceShare = static_cast<float>(territory.owned[i]) / static_cast<float>(totalSpace);
+            const float lengthShare = static_cast<float>(t_board.get_length(i)) / static_cast<float>(totalLength);
+            const float health = static_cast<float>(t_board.get_health(i)) / static_cast<float>(ruleset.startingHealth);
+
+            result[i] = (t_weights.space * spaceShare + t_weights.length * lengthShare + t_weights.health * health) / totalWeight;
+        }
+
+        return result;
+    }
+
+    std::vector<Simulator::Direction> get_safe_moves(const Simulator::Board& t_board, unsigned int t_playerIndex) {
+        if (!t_board.is_alive(t_playerIndex)) {
             return {}; // TODO: change this
         }
 
         std::vector<Simulator::Direction> possibleMoves(DIRECTIONS_MAP.begin(), DIRECTIONS_MAP.end());
         
-        const auto& playerSnake = t_board.get_snake(t_playerId);
+        const auto& playerSnake = t_board.get_snake(t_playerIndex);
         const auto eraseIt = std::remove_if(
             possibleMoves.begin(),
             possibleMoves.end(),
-            [&t_board, &t_playerId, &playerSnake](Simulator::Direction move) -> bool {
+            [&t_board, t_playerIndex, &playerSnake](Simulator::Direction move) -> bool {
                 const Simulator::Position nextPos = Simulator::update_position(playerSnake.get_head(), move);
-                return !t_board.is_safe_cell(t_playerId, nextPos);
+                return !t_board.is_safe_cell(t_playerIndex, nextPos);
             }
         );
         possibleMoves.erase(eraseIt, possibleMoves.end());
@@ -103,8 +219,80 @@ namespace AI {
         return possibleMoves;
     }
 
+    template <class Geometry>
+    std::vector<Simulator::Direction> get_safe_moves(const Simulator::BasicBitBoard<Geometry>& t_board, unsigned int t_playerIndex) {
+        const unsigned int mask = t_board.get_safe_move_mask(t_playerIndex);
+        return std::vector<Simulator::Direction>(MASK_MOVES[mask].begin(), MASK_MOVES[mask].begin() + MASK_MOVE_COUNTS[mask]);
+    }
+
+    std::optional<Engine> engine_from_string(const std::string& t_name) {
+        if (t_name == "seek_food") return Engine::SEEK_FOOD;
+        if (t_name == "suct") return Engine::SUCT;
+        if (t_name == "tree_suct") return Engine::TREE_SUCT;
+        if (t_name == "duct") return Engine::DUCT;
+        if (t_name == "alpha_beta") return Engine::ALPHA_BETA;
+        return std::nullopt;
+    }
+
+    Simulator::Direction engine_player(Engine t_engine, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchTree* t_tree) {
+        switch (t_engine) {
+            case Engine::SUCT:
+                if (t_tree != nullptr) {
+                    return mcts_suct_player(*t_tree, t_board, t_playerIndex, t_params);
+                }
+                return mcts_suct_player(t_board, t_playerIndex, t_params);
+            case Engine::TREE_SUCT:
+                if (t_tree != nullptr) {
+                    return mcts_tree_suct_player(*t_tree, t_board, t_playerIndex, t_params);
+                }
+                return mcts_tree_suct_player(t_board, t_playerIndex, t_params);
+            case Engine::DUCT:
+                return mcts_duct_player(t_board, t_playerIndex, t_params);
+            case Engine::ALPHA_BETA:
+                return alpha_beta_player(t_board, t_playerIndex, t_params);
+            case Engine::SEEK_FOOD:
+                break;
+        }
+
+        Simulator::Rng rng(t_params.seed);
+        if (!Simulator::BitBoard::is_supported(t_board)) {
+            return seek_food_player(t_board, t_playerIndex, rng);
+        }
+
+        // Play on a BitBoard specialised for the board size, or the generic one for unusual sizes
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        return Simulator::dispatch_geometry(ruleset.w, ruleset.h, [&](auto t_geometry) {
+            const Simulator::BasicBitBoard<decltype(t_geometry)> bitBoard(t_board);
+            return seek_food_player(bitBoard, t_playerIndex, rng);
+        });
+    }
+
     unsigned int grid_distance(Simulator::Position t_p1, Simulator::Position t_p2) {
         return std::abs(t_p1.x - t_p2.x) + std::abs(t_p1.y - t_p2.y);
     }
 
+    template Simulator::Direction avoid_walls_player(const Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>>&, unsigned int, Simulator::Rng&);
+    template Simulator::Direction seek_food_player(const Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>>&, unsigned int, Simulator::Rng&);
+    template std::vector<Simulator::Direction> get_safe_moves(const Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>>&, unsigned int);
+    template RewardArray heuristic_evaluate(const Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>>&, HeuristicWeights);
+    template unsigned int rollout_turn(Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>>&, Simulator::Rng&);
+
+    template Simulator::Direction avoid_walls_player(const Simulator::BasicBitBoard<Simulator::FixedGeometry<11, 11>>&, unsigned int, Simulator::Rng&);
+    template Simulator::Direction seek_food_player(const Simulator::BasicBitBoard<Simulator::FixedGeometry<11, 11>>&, unsigned int, Simulator::Rng&);
+    template std::vector<Simulator::Direction> get_safe_moves(const Simulator::BasicBitBoard<Simulator::FixedGeometry<11, 11>>&, unsigned int);
+    template RewardArray heuristic_evaluate(const Simulator::BasicBitBoard<Simulator::FixedGeometry<11, 11>>&, HeuristicWeights);
+    template unsigned int rollout_turn(Simulator::BasicBitBoard<Simulator::FixedGeometry<11, 11>>&, Simulator::Rng&);
+
+    template Simulator::Direction avoid_walls_player(const Simulator::BasicBitBoard<Simulator::FixedGeometry<19, 19>>&, unsigned int, Simulator::Rng&);
+    template Simulator::Direction seek_food_player(const Simulator::BasicBitBoard<Simulator::FixedGeometry<19, 19>>&, unsigned int, Simulator::Rng&);
+    template std::vector<Simulator::Direction> get_safe_moves(const Simulator::BasicBitBoard<Simulator::FixedGeometry<19, 19>>&, unsigned int);
+    template RewardArray heuristic_evaluate(const Simulator::BasicBitBoard<Simulator::FixedGeometry<19, 19>>&, HeuristicWeights);
+    template unsigned int rollout_turn(Simulator::BasicBitBoard<Simulator::FixedGeometry<19, 19>>&, Simulator::Rng&);
+
+    template Simulator::Direction avoid_walls_player(const Simulator::BasicBitBoard<Simulator::DynamicGeometry>&, unsigned int, Simulator::Rng&);
+    template Simulator::Direction seek_food_player(const Simulator::BasicBitBoard<Simulator::DynamicGeometry>&, unsigned int, Simulator::Rng&);
+    template std::vector<Simulator::Direction> get_safe_moves(const Simulator::BasicBitBoard<Simulator::DynamicGeometry>&, unsigned int);
+    template RewardArray heuristic_evaluate(const Simulator::BasicBitBoard<Simulator::DynamicGeometry>&, HeuristicWeights);
+    template unsigned int rollout_turn(Simulator::BasicBitBoard<Simulator::DynamicGeometry>&, Simulator::Rng&);
+
 }
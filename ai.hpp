@@ -2,26 +2,159 @@
 #define AI_INCLUDED
 
 #include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
 
+#include "bitboard.hpp"
+#include "rng.hpp"
 #include "simulator.hpp"
+#include "transposition.hpp"
 
 namespace AI {
 
-    Simulator::Direction random_player(const Simulator::Board& t_board, const std::string& t_playerId);
-    Simulator::Direction avoid_walls_player(const Simulator::Board& t_board, const std::string& t_playerId);
-    Simulator::Direction seek_food_player(const Simulator::Board& t_board, const std::string& t_playerId);
+    // Players are identified by the index of their snake on the board, ties
+    // are broken with t_rng which callers own so that games can be replayed
+    Simulator::Direction random_player(const Simulator::Board& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng);
+    Simulator::Direction avoid_walls_player(const Simulator::Board& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng);
+    Simulator::Direction seek_food_player(const Simulator::Board& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng);
+
+    // Overloads used by the search, defined for every geometry in geometry.hpp
+    template <class Geometry>
+    Simulator::Direction avoid_walls_player(const Simulator::BasicBitBoard<Geometry>& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng);
+    template <class Geometry>
+    Simulator::Direction seek_food_player(const Simulator::BasicBitBoard<Geometry>& t_board, unsigned int t_playerIndex, Simulator::Rng& t_rng);
+
+    // Plays one turn in which every living snake follows avoid_walls_player or
+    // seek_food_player, picked at random. Makes no heap allocations, returns
+    // the number of snakes that moved.
+    template <class Geometry>
+    unsigned int rollout_turn(Simulator::BasicBitBoard<Geometry>& t_board, Simulator::Rng& t_rng);
+
+    // Weights of the terms of heuristic_evaluate, only their ratios matter
+    struct HeuristicWeights {
+        float space;
+        float length;
+        float health;
+    };
+
+    // Rewards are indexed by snake
+    using RewardArray = std::array<float, Simulator::MAX_SNAKES>;
+
+    // Scores every snake in [0, 1] by its share of the cells owned in
+    // BitBoard::get_territory, its share of the total length and its health.
+    // Eliminated snakes score 0. If the weights sum to 0 or less, or are not
+    // numbers, the living snakes score equal shares.
+    template <class Geometry>
+    RewardArray heuristic_evaluate(const Simulator::BasicBitBoard<Geometry>& t_board, HeuristicWeights t_weights);
 
     struct MCTSParameters {
         unsigned int computeTime;
         float ucbConstant;
+        uint64_t seed; // Seeds the generator of the search, each search should be given its own
+        unsigned int threadCount = 1; // Independent searches whose root statistics are merged, 0 is the same as 1
+        unsigned int rolloutDepth = 0; // Turns after which a rollout is scored by heuristic_evaluate, 0 plays to the end
+        HeuristicWeights weights = {1.0f, 0.5f, 0.25f};
+        unsigned int tableMegabytes = 0; // If not 0 SUCT keeps its statistics in a transposition table of this size per thread instead of a tree, alpha_beta_player sizes its table with it
+        bool symmetry = false; // If true positions in the SUCT table share their statistics with their rotations and reflections, only used with tableMegabytes
+    };
+
+    constexpr MCTSParameters DEFAULT_PARAMETERS = {200, 1.0f, 0, 1};
+
+    // Work done by a search, summed over its threads
+    struct SearchStats {
+        uint64_t iterations; // Depths completed by alpha_beta_player
+        uint64_t nodes;
+        TableStats table; // All zero unless the search used a transposition table
+    };
+
+    // Subtrees whose outcome is proven, as far as the search can tell with
+    // safe moves and no food spawning, are no longer sampled, and the search
+    // stops early once the outcome of the root is proven. Opponents are
+    // assumed to know the player's move of the turn when proving outcomes.
+    // Searches with a transposition table do not prove outcomes, and neither
+    // does mcts_tree_suct_player.
+    // If t_stats is not null it is overwritten with the work done by the search
+    Simulator::Direction mcts_suct_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params=DEFAULT_PARAMETERS, SearchStats* t_stats=nullptr);
+    struct SuctTreeState;
+
+    // SUCT tree kept by one player between its moves in a game. The next
+    // search starts from the node below the moves that were played, as long
+    // as they led to the board the tree expected, and the rest of the tree is
+    // freed. Otherwise the search starts from scratch.
+    // With a transposition table the table is kept instead, and entries of
+    // earlier moves are found again by position.
+    class SearchTree {
+    public:
+        SearchTree();
+        ~SearchTree();
+
+        SearchTree(SearchTree&& t_other) noexcept;
+        SearchTree& operator=(SearchTree&& t_other) noexcept;
+
+        // Nodes kept from the previous search, or table entries in use
+        [[nodiscard]] size_t size() const;
+
+        friend Simulator::Direction mcts_suct_player(SearchTree& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats);
+        friend void mcts_suct_ponder(SearchTree& t_tree, Simulator::Direction t_move, MCTSParameters t_params, const std::atomic<bool>& t_stop, SearchStats* t_stats);
+        friend Simulator::Direction mcts_tree_suct_player(SearchTree& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats);
+    private:
+        std::unique_ptr<SuctTreeState> m_state;
+    };
+
+    // Same as mcts_suct_player, continuing from the tree of this player's previous move.
+    // With several threads only the tree of the first one is kept.
+    Simulator::Direction mcts_suct_player(SearchTree& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params=DEFAULT_PARAMETERS, SearchStats* t_stats=nullptr);
+
+    // Keeps searching t_tree from the positions following t_move, the move
+    // its last search chose, so that the next search starts from a larger
+    // subtree. Runs on the calling thread until t_stop is set or computeTime
+    // of t_params runs out, single threaded whatever threadCount is. Nothing
+    // else may use t_tree until it returns.
+    void mcts_suct_ponder(SearchTree& t_tree, Simulator::Direction t_move, MCTSParameters t_params, const std::atomic<bool>& t_stop, SearchStats* t_stats=nullptr);
+
+    // Same search as mcts_suct_player, but the threads share a single tree instead of searching one each.
+    // Outcomes are not proven, so the search always runs for computeTime.
+    Simulator::Direction mcts_tree_suct_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params=DEFAULT_PARAMETERS, SearchStats* t_stats=nullptr);
+    // Same as mcts_tree_suct_player, with the shared tree held by t_tree. The
+    // first search allocates it and later ones reuse its memory, but nothing
+    // of the search is kept between moves.
+    Simulator::Direction mcts_tree_suct_player(SearchTree& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params=DEFAULT_PARAMETERS, SearchStats* t_stats=nullptr);
+    Simulator::Direction mcts_duct_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params=DEFAULT_PARAMETERS);
+
+    // Deterministic paranoid alpha-beta search, deepened one turn at a time
+    // until computeTime runs out. Scores boards with heuristic_evaluate and
+    // uses only computeTime, weights and tableMegabytes of t_params.
+    Simulator::Direction alpha_beta_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params=DEFAULT_PARAMETERS, SearchStats* t_stats=nullptr);
+
+    // Once the snakes cannot reach each other for some turns, each one only
+    // has to survive in its own region and the longest survival of each is
+    // found exactly by a depth first search. Returns the move the player
+    // survives longest with if that decides the game before the snakes can
+    // meet, otherwise nothing. Food spawning is not accounted for. The SUCT
+    // players play this move instead of searching.
+    std::optional<Simulator::Direction> endgame_player(const Simulator::Board& t_board, unsigned int t_playerIndex, SearchStats* t_stats=nullptr);
+
+    // Players that ai_run and the server can be told to use by name
+    enum class Engine {
+        SEEK_FOOD,
+        SUCT,
+        TREE_SUCT,
+        DUCT,
+        ALPHA_BETA
     };
 
-    constexpr MCTSParameters DEFAULT_PARAMETERS = {200, 1.0f};
+    // Accepts "seek_food", "suct", "tree_suct", "duct" and "alpha_beta"
+    std::optional<Engine> engine_from_string(const std::string& t_name);
 
-    Simulator::Direction mcts_suct_player(const Simulator::Board& t_board, const std::string& t_playerId, MCTSParameters t_params=DEFAULT_PARAMETERS);
-    Simulator::Direction mcts_duct_player(const Simulator::Board& t_board, const std::string& t_playerId, MCTSParameters t_params=DEFAULT_PARAMETERS);
+    // Chooses a move with t_engine, seek_food only uses the seed of t_params.
+    // If t_tree is not null suct continues from it and tree_suct searches with its shared tree.
+    Simulator::Direction engine_player(Engine t_engine, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params=DEFAULT_PARAMETERS, SearchTree* t_tree=nullptr);
 
-    std::vector<Simulator::Direction> get_safe_moves(const Simulator::Board& t_board, const std::string& t_playerId);
+    std::vector<Simulator::Direction> get_safe_moves(const Simulator::Board& t_board, unsigned int t_playerIndex);
+    template <class Geometry>
+    std::vector<Simulator::Direction> get_safe_moves(const Simulator::BasicBitBoard<Geometry>& t_board, unsigned int t_playerIndex);
 
     constexpr std::array<Simulator::Direction, 4> DIRECTIONS_MAP {
         Simulator::Direction::UP,
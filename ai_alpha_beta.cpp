@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "ai.hpp"
+#include "transposition.hpp"
+
+namespace AI {
+
+    // Paranoid alpha-beta: in every turn the searching player picks its move
+    // first and the other players then answer together with the joint move
+    // that is worst for it, so a turn is one max and one min level. The depth
+    // is counted in turns and deepened one turn at a time until computeTime
+    // runs out, the result of the last complete depth is played.
+
+    namespace {
+
+        enum class Bound : uint8_t {
+            EXACT,
+            LOWER,
+            UPPER
+        };
+
+        // Kept for boards at the start of a turn, the value is that of the searching player
+        struct AlphaBetaEntry {
+            float value = 0.0f;
+            uint8_t depth = 0;
+            Bound bound = Bound::EXACT;
+            Simulator::Direction move = Simulator::Direction::UP; // Best move found
+            uint16_t reply = 0; // Best joint reply to move, packed by ab_pack_reply
+
+            [[nodiscard]] unsigned int weight() const {
+                return depth;
+            }
+        };
+
+        using AlphaBetaTable = TranspositionTable<AlphaBetaEntry>;
+        using Clock = std::chrono::high_resolution_clock;
+
+        // Used when t_params.tableMegabytes is 0
+        constexpr unsigned int DEFAULT_TABLE_MEGABYTES = 4;
+        constexpr unsigned int MAX_DEPTH = 64;
+        // The clock is read once every CLOCK_INTERVAL nodes
+        constexpr uint64_t CLOCK_INTERVAL = 256;
+
+        // Heuristic values lie in [0, 1], below every win and above every
+        // loss. Earlier wins and later losses are preferred, by ply.
+        constexpr float WIN = 2.0f;
+        constexpr float LOSS = -1.0f;
+        constexpr float DRAW = 0.0f;
+        constexpr float PLY_PENALTY = 0.001f;
+
+        // Joint replies of the other players, up to 4^(MAX_SNAKES - 1) of them
+        using ReplyList = std::vector<Simulator::MoveArray>;
+
+        struct Search {
+            unsigned int playerIndex;
+            MCTSParameters params;
+            Clock::time_point deadline;
+            AlphaBetaTable table;
+            uint64_t nodes = 0;
+            bool stopped = false; // Set once the deadline passes, every value found after is discarded
+            std::array<ReplyList, MAX_DEPTH> replies{}; // Indexed by ply, reused so that each list only grows once
+        };
+
+    }
+
+    template <class BitBoard>
+    Simulator::Direction ab_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats);
+
+    // Value of t_board for the searching player, searched t_depth turns
+    // deep. If t_bestMove is not null it is set to the move of that value.
+    // Leaves t_board unchanged when it returns.
+    template <class BitBoard>
+    float ab_node(BitBoard& t_board, Search& t_search, unsigned int t_depth, float t_alpha, float t_beta, unsigned int t_ply, Simulator::Direction* t_bestMove);
+
+    // Called once the player is eliminated or the game is over
+    template <class BitBoard>
+    float ab_evaluate_terminal(const BitBoard& t_board, unsigned int t_playerIndex, unsigned int t_ply);
+
+    // Safe moves of t_playerIndex with t_first, if safe, moved to the front. Without a safe move the player steps UP.
+    template <class BitBoard>
+    unsigned int ab_get_moves(const BitBoard& t_board, unsigned int t_playerIndex, Simulator::Direction t_first, std::array<Simulator::Direction, 4>& t_moves);
+
+    // Every joint move of the other living players, with t_first, if present, at the front
+    template <class BitBoard>
+    void ab_get_replies(const BitBoard& t_board, unsigned int t_playerIndex, uint16_t t_first, ReplyList& t_replies);
+
+    // Two bits for each snake but the searching player, in order
+    uint16_t ab_pack_reply(const Simulator::MoveArray& t_reply, unsigned int t_snakeCount, unsigned int t_playerIndex);
+
+    // Wins and losses are stored as distances from the node rather than from
+    // the root, so that a position reached at another ply reads the right one
+    float ab_value_to_table(float t_value, unsigned int t_ply);
+    float ab_value_from_table(float t_value, unsigned int t_ply);
+
+
+    Simulator::Direction alpha_beta_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats) {
+        if (!Simulator::BitBoard::is_supported(t_board)) {
+            if (t_stats != nullptr) {
+                *t_stats = SearchStats{};
+            }
+
+            Simulator::Rng rng(t_params.seed);
+            return seek_food_player(t_board, t_playerIndex, rng);
+        }
+
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        return Simulator::dispatch_geometry(ruleset.w, ruleset.h, [&](auto t_geometry) {
+            return ab_search<Simulator::BasicBitBoard<decltype(t_geometry)>>(t_board, t_playerIndex, t_params, t_stats);
+        });
+    }
+
+    template <class BitBoard>
+    Simulator::Direction ab_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats) {
+        const Clock::time_point t1 = Clock::now();
+
+        // Food spawning is random, so the search plays without it as the other engines do
+        Simulator::Ruleset ruleset = t_board.get_ruleset();
+        ruleset.spawnFood = false;
+        BitBoard board{Simulator::Board{t_board, ruleset}};
+
+        const unsigned int megabytes = (t_params.tableMegabytes != 0) ? t_params.tableMegabytes : DEFAULT_TABLE_MEGABYTES;
+        Search search{t_playerIndex, t_params, t1 + std::chrono::milliseconds(t_params.computeTime), AlphaBetaTable(megabytes)};
+
+        // Played if not even the first depth completes
+        std::array<Simulator::Direction, 4> moves{};
+        ab_get_moves(board, t_playerIndex, Simulator::Direction::UP, moves);
+        Simulator::Direction bestMove = moves[0];
+
+        unsigned int completedDepth = 0;
+        if (!board.is_game_over()) {
+            for (unsigned int depth = 1; depth <= MAX_DEPTH; depth++) {
+                Simulator::Direction move = bestMove;
+                const float value = ab_node(board, search, depth, -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), 0, &move);
+                if (search.stopped) break;
+
+                bestMove = move;
+                completedDepth = depth;
+
+                // Deeper searches cannot change a forced result
+                if (value >= WIN - MAX_DEPTH * PLY_PENALTY || value <= LOSS + MAX_DEPTH * PLY_PENALTY) break;
+            }
+        }
+
+        if (t_stats != nullptr) {
+            *t_stats = SearchStats{completedDepth, search.nodes, search.table.get_stats()};
+        }
+
+        return bestMove;
+    }
+
+    template <class BitBoard>
+    float ab_node(BitBoard& t_board, Search& t_search, unsigned int t_depth, float t_alpha, float t_beta, unsigned int t_ply, Simulator::Direction* t_bestMove) {
+        if (t_search.nodes++ % CLOCK_INTERVAL == 0 && Clock::now() >= t_search.deadline) {
+            t_search.stopped = true;
+        }
+        if (t_search.stopped) {
+            return 0.0f;
+        }
+
+        const unsigned int player = t_search.playerIndex;
+        if (!t_board.is_alive(player) || t_board.is_game_over()) {
+            return ab_evaluate_terminal(t_board, player, t_ply);
+        }
+        if (t_depth == 0) {
+            return heuristic_evaluate(t_board, t_search.params.weights)[player];
+        }
+
+        const uint64_t key = t_board.get_hash();
+        Simulator::Direction firstMove = Simulator::Direction::UP;
+        uint16_t firstReply = 0;
+        if (const AlphaBetaEntry* entry = t_search.table.probe(key)) {
+            // The root always searches, so that its move is known
+            if (entry->depth >= t_depth && t_bestMove == nullptr) {
+                const float value = ab_value_from_table(entry->value, t_ply);
+                if (entry->bound == Bound::EXACT) return value;
+                if (entry->bound == Bound::LOWER && value >= t_beta) return value;
+                if (entry->bound == Bound::UPPER && value <= t_alpha) return value;
+            }
+            firstMove = entry->move;
+            firstReply = entry->reply;
+        }
+
+        std::array<Simulator::Direction, 4> moves{};
+        const unsigned int moveCount = ab_get_moves(t_board, player, firstMove, moves);
+
+        const float alpha = t_alpha;
+        float best = -std::numeric_limits<float>::infinity();
+        Simulator::Direction bestMove = moves[0];
+        uint16_t bestReply = 0;
+        for (unsigned int i = 0; i < moveCount; i++) {
+            const float floor = std::max(t_alpha, best);
+
+            // Children use the lists of later plies, so this one stays intact
+            ReplyList& replies = t_search.replies[t_ply];
+            ab_get_replies(t_board, player, (moves[i] == firstMove) ? firstReply : 0, replies);
+
+            // Min level, the other players stop looking once this move cannot beat floor
+            float value = std::numeric_limits<float>::infinity();
+            uint16_t reply = 0;
+            for (unsigned int j = 0; j < replies.size(); j++) {
+                Simulator::MoveArray joint = replies[j];
+                joint[player] = moves[i];
+
+                const typename BitBoard::Undo undo = t_board.make_move(joint);
+                const float childValue = ab_node(t_board, t_search, t_depth - 1, floor, std::min(t_beta, value), t_ply + 1, nullptr);
+                t_board.unmake_move(undo);
+
+                if (t_search.stopped) {
+                    return 0.0f;
+                }
+
+                if (childValue < value) {
+                    value = childValue;
+                    reply = ab_pack_reply(replies[j], t_board.get_snake_count(), player);
+                }
+                if (value <= floor) break;
+            }
+
+            if (value > best) {
+                best = value;
+                bestMove = moves[i];
+                bestReply = reply;
+            }
+            if (best >= t_beta) break;
+        }
+
+        AlphaBetaEntry& entry = t_search.table.store(key);
+        entry.value = ab_value_to_table(best, t_ply);
+        entry.depth = static_cast<uint8_t>(t_depth);
+        entry.bound = (best <= alpha) ? Bound::UPPER : (best >= t_beta) ? Bound::LOWER : Bound::EXACT;
+        entry.move = bestMove;
+        entry.reply = bestReply;
+
+        if (t_bestMove != nullptr) {
+            *t_bestMove = bestMove;
+        }
+
+        return best;
+    }
+
+    template <class BitBoard>
+    float ab_evaluate_terminal(const BitBoard& t_board, unsigned int t_playerIndex, unsigned int t_ply) {
+        if (t_board.is_alive(t_playerIndex)) {
+            return WIN - t_ply * PLY_PENALTY;
+        }
+
+        // The player was alive a turn ago, so if nobody is left everyone died at once
+        const bool othersAlive = !t_board.is_game_over() || t_board.get_winner() < t_board.get_snake_count();
+        return othersAlive ? LOSS + t_ply * PLY_PENALTY : DRAW;
+    }
+
+    template <class BitBoard>
+    unsigned int ab_get_moves(const BitBoard& t_board, unsigned int t_playerIndex, Simulator::Direction t_first, std::array<Simulator::Direction, 4>& t_moves) {
+        const unsigned int mask = t_board.get_safe_move_mask(t_playerIndex);
+        if (mask == 0) {
+            t_moves[0] = Simulator::Direction::UP;
+            return 1;
+        }
+
+        unsigned int count = 0;
+        if ((mask >> static_cast<unsigned int>(t_first)) & 1) {
+            t_moves[count++] = t_first;
+        }
+        for (const Simulator::Direction move : DIRECTIONS_MAP) {
+            if (move != t_first && ((mask >> static_cast<unsigned int>(move)) & 1)) {
+                t_moves[count++] = move;
+            }
+        }
+
+        return count;
+    }
+
+    template <class BitBoard>
+    void ab_get_replies(const BitBoard& t_board, unsigned int t_playerIndex, uint16_t t_first, ReplyList& t_replies) {
+        // Moves of each other living player, the joint replies are counted through in mixed radix
+        std::array<unsigned int, Simulator::MAX_SNAKES> opponents{};
+        std::array<std::array<Simulator::Direction, 4>, Simulator::MAX_SNAKES> options{};
+        std::array<unsigned int, Simulator::MAX_SNAKES> optionCounts{};
+        unsigned int opponentCount = 0;
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (i == t_playerIndex || !t_board.is_alive(i)) continue;
+
+            opponents[opponentCount] = i;
+            optionCounts[opponentCount] = ab_get_moves(t_board, i, Simulator::Direction::UP, options[opponentCount]);
+            opponentCount++;
+        }
+
+        std::array<unsigned int, Simulator::MAX_SNAKES> digits{};
+        t_replies.clear();
+        for (bool done = false; !done; ) {
+            Simulator::MoveArray& reply = t_replies.emplace_back();
+            for (unsigned int k = 0; k < opponentCount; k++) {
+                reply[opponents[k]] = options[k][digits[k]];
+            }
+
+            done = true;
+            for (unsigned int k = 0; k < opponentCount; k++) {
+                if (++digits[k] < optionCounts[k]) {
+                    done = false;
+                    break;
+                }
+                digits[k] = 0;
+            }
+        }
+
+        for (unsigned int i = 1; i < t_replies.size(); i++) {
+            if (ab_pack_reply(t_replies[i], t_board.get_snake_count(), t_playerIndex) == t_first) {
+                std::swap(t_replies[0], t_replies[i]);
+                break;
+            }
+        }
+    }
+
+    uint16_t ab_pack_reply(const Simulator::MoveArray& t_reply, unsigned int t_snakeCount, unsigned int t_playerIndex) {
+        static_assert(2 * (Simulator::MAX_SNAKES - 1) <= 16);
+
+        uint16_t result = 0;
+        unsigned int shift = 0;
+        for (unsigned int i = 0; i < t_snakeCount; i++) {
+            if (i != t_playerIndex) {
+                result |= static_cast<uint16_t>(static_cast<unsigned int>(t_reply[i]) << shift);
+                shift += 2;
+            }
+        }
+        return result;
+    }
+
+    float ab_value_to_table(float t_value, unsigned int t_ply) {
+        if (t_value >= WIN - MAX_DEPTH * PLY_PENALTY) return t_value + t_ply * PLY_PENALTY;
+        if (t_value <= LOSS + MAX_DEPTH * PLY_PENALTY) return t_value - t_ply * PLY_PENALTY;
+        return t_value;
+    }
+
+    float ab_value_from_table(float t_value, unsigned int t_ply) {
+        if (t_value >= WIN - MAX_DEPTH * PLY_PENALTY) return t_value - t_ply * PLY_PENALTY;
+        if (t_value <= LOSS + MAX_DEPTH * PLY_PENALTY) return t_value + t_ply * PLY_PENALTY;
+        return t_value;
+    }
+
+}
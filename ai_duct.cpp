@@ -0,0 +1,251 @@
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "ai.hpp"
+#include "arena.hpp"
+
+namespace AI {
+
+    // Decoupled UCT: every node is a whole game turn and each player picks
+    // its own move with UCB over statistics of its own moves only, as if the
+    // other players were part of the environment. The moves of all players
+    // together select the child.
+
+    namespace {
+
+        struct Node {
+            unsigned int visitCount = 0;
+
+            // Statistics of each player's moves, indexed by snake then by Direction
+            std::array<std::array<unsigned int, 4>, Simulator::MAX_SNAKES> moveVisits{};
+            std::array<std::array<float, 4>, Simulator::MAX_SNAKES> moveRewards{};
+
+            // Children are kept in a list as there can be up to 4^MAX_SNAKES of them
+            Arena<Node>::Index firstChild = Arena<Node>::NONE;
+            Arena<Node>::Index nextSibling = Arena<Node>::NONE;
+            uint16_t moves = 0; // Moves leading to this node, packed by duct_pack_moves
+        };
+
+        using NodeArena = Arena<Node>;
+        using NodeIndex = NodeArena::Index;
+
+    }
+
+    template <class BitBoard>
+    Simulator::Direction duct_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params);
+
+    // Leaves t_board unchanged when it returns
+    template <class BitBoard>
+    RewardArray duct_mcts_iter(BitBoard& t_board, NodeArena& t_nodes, NodeIndex t_node, MCTSParameters t_params, Simulator::Rng& t_rng);
+
+    template <class BitBoard>
+    RewardArray duct_mcts_rollout(const BitBoard& t_board, MCTSParameters t_params, Simulator::Rng& t_rng);
+    template <class BitBoard>
+    RewardArray duct_evaluate_board(const BitBoard& t_board);
+
+    Simulator::Direction duct_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const Node& t_node, unsigned int t_playerIndex, MCTSParameters t_params, Simulator::Rng& t_rng);
+    void duct_update_node(Node& t_node, const Simulator::MoveArray& t_moves, uint8_t t_players, const RewardArray& t_rewards);
+
+    // Two bits per snake
+    uint16_t duct_pack_moves(const Simulator::MoveArray& t_moves, uint8_t t_players);
+    NodeIndex duct_find_child(const NodeArena& t_nodes, NodeIndex t_node, uint16_t t_moves);
+
+
+    Simulator::Direction mcts_duct_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params) {
+        if (!Simulator::BitBoard::is_supported(t_board)) {
+            Simulator::Rng rng(t_params.seed);
+            return seek_food_player(t_board, t_playerIndex, rng);
+        }
+
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        return Simulator::dispatch_geometry(ruleset.w, ruleset.h, [&](auto t_geometry) {
+            return duct_search<Simulator::BasicBitBoard<decltype(t_geometry)>>(t_board, t_playerIndex, t_params);
+        });
+    }
+
+    template <class BitBoard>
+    Simulator::Direction duct_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params) {
+        using std::chrono::duration_cast;
+        using std::chrono::high_resolution_clock;
+        using std::chrono::milliseconds;
+
+        const auto t1 = high_resolution_clock::now();
+
+        Simulator::Rng rng(t_params.seed);
+
+        // Disable food spawning in search to reduce the number of nodes to be visited
+        Simulator::Ruleset ruleset = t_board.get_ruleset();
+        ruleset.spawnFood = false;
+        BitBoard board{Simulator::Board{t_board, ruleset}};
+
+        NodeArena nodes(1 << 14);
+        const NodeIndex root = nodes.allocate();
+
+        while (duration_cast<milliseconds>(high_resolution_clock::now() - t1).count() < t_params.computeTime) {
+            duct_mcts_iter(board, nodes, root, t_params, rng);
+        }
+
+        const std::vector<Simulator::Direction> safeMoves = get_safe_moves(board, t_playerIndex);
+        if (safeMoves.empty()) {
+            return Simulator::Direction::UP;
+        }
+
+        // The move with the best average reward, as for SUCT
+        const Node& node = nodes[root];
+        Simulator::Direction bestMove = safeMoves[0];
+        float bestMoveScore = -std::numeric_limits<float>::infinity();
+        for (const Simulator::Direction move : safeMoves) {
+            const unsigned int visitCount = node.moveVisits[t_playerIndex][static_cast<unsigned int>(move)];
+            if (visitCount != 0) {
+                const float score = node.moveRewards[t_playerIndex][static_cast<unsigned int>(move)] / static_cast<float>(visitCount);
+                if (score > bestMoveScore) {
+                    bestMove = move;
+                    bestMoveScore = score;
+                }
+            }
+        }
+
+        return bestMove;
+    }
+
+    template <class BitBoard>
+    RewardArray duct_mcts_iter(BitBoard& t_board, NodeArena& t_nodes, NodeIndex t_node, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        if (t_board.is_game_over()) {
+            return duct_evaluate_board(t_board);
+        }
+
+        // Players without a safe move are stepped into their death
+        uint8_t players = 0;
+        Simulator::MoveArray moves{};
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (!t_board.is_alive(i)) continue;
+
+            players |= (1u << i);
+            moves[i] = duct_select_move(get_safe_moves(t_board, i), t_nodes[t_node], i, t_params, t_rng);
+        }
+
+        const uint16_t packedMoves = duct_pack_moves(moves, players);
+        NodeIndex child = duct_find_child(t_nodes, t_node, packedMoves);
+
+        const typename BitBoard::Undo undo = t_board.make_move(moves);
+
+        RewardArray rewards;
+        if (child == NodeArena::NONE) {
+            // Allocating may move the nodes, so they are only ever held by index
+            child = t_nodes.allocate();
+            t_nodes[child].moves = packedMoves;
+            t_nodes[child].nextSibling = t_nodes[t_node].firstChild;
+            t_nodes[t_node].firstChild = child;
+
+            rewards = duct_mcts_rollout(t_board, t_params, t_rng);
+            t_nodes[child].visitCount = 1;
+        }
+        else {
+            rewards = duct_mcts_iter(t_board, t_nodes, child, t_params, t_rng);
+        }
+
+        t_board.unmake_move(undo);
+
+        duct_update_node(t_nodes[t_node], moves, players, rewards);
+
+        return rewards;
+    }
+
+    template <class BitBoard>
+    RewardArray duct_mcts_rollout(const BitBoard& t_board, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        BitBoard board = t_board;
+        for (unsigned int turns = 0; !board.is_game_over(); turns++) {
+            if (turns == t_params.rolloutDepth && t_params.rolloutDepth != 0) {
+                return heuristic_evaluate(board, t_params.weights);
+            }
+
+            rollout_turn(board, t_rng);
+        }
+        return duct_evaluate_board(board);
+    }
+
+    template <class BitBoard>
+    RewardArray duct_evaluate_board(const BitBoard& t_board) {
+        RewardArray result{};
+
+        const unsigned int winner = t_board.get_winner();
+        if (winner < t_board.get_snake_count()) {
+            result[winner] = 1.0f;
+        }
+
+        return result;
+    }
+
+    Simulator::Direction duct_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const Node& t_node, unsigned int t_playerIndex, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        if (t_safeMoves.empty()) {
+            return Simulator::Direction::UP;
+        }
+
+        const std::array<unsigned int, 4>& visits = t_node.moveVisits[t_playerIndex];
+        const std::array<float, 4>& rewards = t_node.moveRewards[t_playerIndex];
+
+        // Untried moves are tried first in a random order
+        std::array<Simulator::Direction, 4> untried{};
+        unsigned int untriedCount = 0;
+        for (const Simulator::Direction move : t_safeMoves) {
+            if (visits[static_cast<unsigned int>(move)] == 0) {
+                untried[untriedCount++] = move;
+            }
+        }
+        if (untriedCount != 0) {
+            return untried[t_rng.below(untriedCount)];
+        }
+
+        // Parent count of the player's own moves, the node count also holds visits where the player had no safe move
+        unsigned int N = 0;
+        for (const Simulator::Direction move : t_safeMoves) {
+            N += visits[static_cast<unsigned int>(move)];
+        }
+
+        Simulator::Direction bestMove = t_safeMoves[0];
+        float bestMoveUCB = -std::numeric_limits<float>::infinity();
+        for (const Simulator::Direction move : t_safeMoves) {
+            const unsigned int n = visits[static_cast<unsigned int>(move)];
+            const float ucb = (rewards[static_cast<unsigned int>(move)] / n) + t_params.ucbConstant * std::sqrt(std::log(N) / n);
+            if (ucb > bestMoveUCB) {
+                bestMove = move;
+                bestMoveUCB = ucb;
+            }
+        }
+
+        return bestMove;
+    }
+
+    void duct_update_node(Node& t_node, const Simulator::MoveArray& t_moves, uint8_t t_players, const RewardArray& t_rewards) {
+        for (unsigned int i = 0; i < Simulator::MAX_SNAKES; i++) {
+            if (!((t_players >> i) & 1)) continue;
+
+            const unsigned int move = static_cast<unsigned int>(t_moves[i]);
+            t_node.moveVisits[i][move]++;
+            t_node.moveRewards[i][move] += t_rewards[i];
+        }
+        t_node.visitCount++;
+    }
+
+    uint16_t duct_pack_moves(const Simulator::MoveArray& t_moves, uint8_t t_players) {
+        uint16_t result = 0;
+        for (unsigned int i = 0; i < Simulator::MAX_SNAKES; i++) {
+            if ((t_players >> i) & 1) {
+                result |= static_cast<uint16_t>(static_cast<unsigned int>(t_moves[i]) << (2 * i));
+            }
+        }
+        return result;
+    }
+
+    NodeIndex duct_find_child(const NodeArena& t_nodes, NodeIndex t_node, uint16_t t_moves) {
+        for (NodeIndex child = t_nodes[t_node].firstChild; child != NodeArena::NONE; child = t_nodes[child].nextSibling) {
+            if (t_nodes[child].moves == t_moves) {
+                return child;
+            }
+        }
+        return NodeArena::NONE;
+    }
+
+}
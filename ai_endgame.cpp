@@ -0,0 +1,421 @@
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "ai.hpp"
+#include "bitboard.hpp"
+#include "geometry.hpp"
+
+namespace AI {
+
+    // Once the snakes are sealed off from each other, each one only has to
+    // outlast the others in its own region. Regions are grown from every head
+    // a turn at a time, as bit sets. A body segment is a wall until the turn
+    // its snake's tail would have left it if the snake never ate, and cells
+    // stay in a region once reached, so a region holds every cell its snake
+    // could be on by then. Up to the last turn no region meets another region
+    // or another snake's body, the snakes cannot affect each other, and the
+    // longest survival of each snake alone is an exact depth first search.
+
+    namespace {
+
+        using Simulator::CellSet;
+
+        // Turns the regions are grown and the survival searched for at most
+        constexpr unsigned int ENDGAME_HORIZON = 64;
+        // Search nodes per call, past which survival lengths are only lower bounds
+        constexpr uint64_t ENDGAME_NODE_LIMIT = 1 << 15;
+
+        struct EndgameBoard {
+            Simulator::DynamicGeometry geometry;
+            // Cells that can be shifted in each direction without leaving the board
+            CellSet board;
+            CellSet notFirstColumn;
+            CellSet notLastColumn;
+            CellSet food;
+            int maxHealth;
+        };
+
+        // A snake played on its own, the cells from index tail of body onwards are the snake from its tail
+        struct EndgameSnake {
+            std::vector<uint16_t> body;
+            size_t tail;
+            CellSet occupied;
+            CellSet walls; // Bodies of the other snakes
+            int health;
+        };
+
+        // State changed by endgame_make_move that endgame_unmake_move cannot work out
+        struct EndgameUndo {
+            bool ate;
+            int health;
+        };
+
+        struct EndgameSearch {
+            const EndgameBoard& board;
+            EndgameSnake snake;
+            CellSet food; // Food not eaten yet on the current path
+            unsigned int horizon;
+            uint64_t nodes = 0;
+            bool exhausted = false; // Set once the node limit is reached
+        };
+
+    }
+
+    EndgameBoard endgame_make_board(const Simulator::Board& t_board);
+    // Cells next to one of t_cells
+    CellSet endgame_neighbours(const EndgameBoard& t_board, const CellSet& t_cells);
+
+    // Last turn up to which no snake can meet another, 0 if they may meet on the next turn
+    unsigned int endgame_separation(const Simulator::Board& t_board, const EndgameBoard& t_endgame);
+
+    // Turns snake t_index survives alone, at most t_search.horizon. Leaves t_search.snake
+    // unchanged. The value is exact if it is above t_floor and no more than t_floor otherwise.
+    unsigned int endgame_survival(EndgameSearch& t_search, unsigned int t_depth, unsigned int t_floor);
+    // Upper bound on endgame_survival from the cells the head could be on each turn
+    unsigned int endgame_bound(const EndgameSearch& t_search, unsigned int t_depth);
+
+    EndgameSnake endgame_make_snake(const Simulator::Board& t_board, const EndgameBoard& t_endgame, unsigned int t_index);
+    // Moves the snake if it survives the move and returns whether it did, t_undo is only set if it did
+    bool endgame_make_move(EndgameSearch& t_search, Simulator::Direction t_move, EndgameUndo& t_undo);
+    void endgame_unmake_move(EndgameSearch& t_search, const EndgameUndo& t_undo);
+
+
+    std::optional<Simulator::Direction> endgame_player(const Simulator::Board& t_board, unsigned int t_playerIndex, SearchStats* t_stats) {
+        if (t_stats != nullptr) {
+            *t_stats = SearchStats{};
+        }
+
+        if (t_board.is_game_over() || !t_board.is_alive(t_playerIndex) || !Simulator::BitBoard::is_supported(t_board)) {
+            return std::nullopt;
+        }
+
+        const EndgameBoard endgame = endgame_make_board(t_board);
+        const unsigned int horizon = endgame_separation(t_board, endgame);
+        if (horizon == 0) {
+            return std::nullopt;
+        }
+
+        EndgameSearch search{endgame, endgame_make_snake(t_board, endgame, t_playerIndex), endgame.food, horizon};
+
+        // Moves that do not survive a turn are worth 0 and only played if nothing else is
+        Simulator::Direction bestMove = Simulator::Direction::UP;
+        unsigned int best = 0;
+        for (const Simulator::Direction move : DIRECTIONS_MAP) {
+            EndgameUndo undo;
+            if (!endgame_make_move(search, move, undo)) continue;
+
+            const unsigned int survival = endgame_survival(search, 1, best);
+            endgame_unmake_move(search, undo);
+
+            if (survival > best) {
+                bestMove = move;
+                best = survival;
+            }
+            if (best == horizon) break;
+        }
+
+        // The player outlasts the separation, which decides the game only if every other snake dies before it ends
+        bool decided = !search.exhausted;
+        if (best == horizon) {
+            decided = true;
+            for (unsigned int i = 0; i < t_board.get_snake_count() && decided; i++) {
+                if (i == t_playerIndex || !t_board.is_alive(i)) continue;
+
+                EndgameSearch other{endgame, endgame_make_snake(t_board, endgame, i), endgame.food, horizon};
+                other.nodes = search.nodes;
+                decided = endgame_survival(other, 0, 0) < horizon && !other.exhausted;
+                search.nodes = other.nodes;
+            }
+        }
+
+        if (t_stats != nullptr) {
+            *t_stats = SearchStats{0, search.nodes, TableStats{}};
+        }
+
+        return decided ? std::optional<Simulator::Direction>(bestMove) : std::nullopt;
+    }
+
+    EndgameBoard endgame_make_board(const Simulator::Board& t_board) {
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        EndgameBoard result{Simulator::DynamicGeometry(ruleset.w, ruleset.h), {}, {}, {}, {}, ruleset.startingHealth};
+
+        for (unsigned int y = 0; y < ruleset.h; y++) {
+            for (unsigned int x = 0; x < ruleset.w; x++) {
+                const unsigned int cell = y * ruleset.w + x;
+                result.board.set(cell);
+                if (x != 0) {
+                    result.notFirstColumn.set(cell);
+                }
+                if (x + 1 != ruleset.w) {
+                    result.notLastColumn.set(cell);
+                }
+                if (t_board.has_food(Simulator::Position{static_cast<int>(x), static_cast<int>(y)})) {
+                    result.food.set(cell);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    CellSet endgame_neighbours(const EndgameBoard& t_board, const CellSet& t_cells) {
+        const unsigned int w = t_board.geometry.get_width();
+
+        CellSet result;
+        CellSet shifted = t_cells;
+        shifted <<= w;
+        result |= shifted;
+        shifted = t_cells;
+        shifted >>= w;
+        result |= shifted;
+
+        // A cell only spreads sideways within its row
+        shifted = t_cells;
+        shifted &= t_board.notLastColumn;
+        shifted <<= 1;
+        result |= shifted;
+        shifted = t_cells;
+        shifted &= t_board.notFirstColumn;
+        shifted >>= 1;
+        result |= shifted;
+
+        result &= t_board.board;
+        return result;
+    }
+
+    unsigned int endgame_separation(const Simulator::Board& t_board, const EndgameBoard& t_endgame) {
+        const Simulator::DynamicGeometry& geometry = t_endgame.geometry;
+        const unsigned int snakeCount = t_board.get_snake_count();
+
+        // Every segment is listed with the turn it opens on, the head last
+        std::vector<std::pair<unsigned int, uint16_t>> openings;
+        std::array<CellSet, Simulator::MAX_SNAKES> bodies{};
+        std::array<CellSet, Simulator::MAX_SNAKES> regions{};
+        CellSet walls;
+        for (unsigned int i = 0; i < snakeCount; i++) {
+            if (!t_board.is_alive(i)) continue;
+
+            unsigned int turn = 1;
+            for (const Simulator::Position segment : t_board.get_snake(i)) {
+                const unsigned int cell = geometry.to_cell(segment);
+                bodies[i].set(cell);
+                openings.emplace_back(turn++, static_cast<uint16_t>(cell));
+            }
+            regions[i].set(geometry.to_cell(t_board.get_snake(i).get_head()));
+            walls |= bodies[i];
+        }
+
+        // A cell holding several segments opens with the last of them
+        std::sort(openings.begin(), openings.end());
+        std::array<uint16_t, Simulator::MAX_BOARD_CELLS> opensOn{};
+        for (const auto& [turn, cell] : openings) {
+            opensOn[cell] = static_cast<uint16_t>(turn);
+        }
+
+        size_t nextOpening = 0;
+        for (unsigned int turn = 1; turn <= ENDGAME_HORIZON; turn++) {
+            for (; nextOpening < openings.size() && openings[nextOpening].first <= turn; nextOpening++) {
+                const uint16_t cell = openings[nextOpening].second;
+                if (opensOn[cell] <= turn) {
+                    walls.reset(cell);
+                }
+            }
+
+            for (unsigned int i = 0; i < snakeCount; i++) {
+                if (!t_board.is_alive(i)) continue;
+
+                CellSet grown = endgame_neighbours(t_endgame, regions[i]);
+                grown.and_not(walls);
+                regions[i] |= grown;
+            }
+
+            for (unsigned int i = 0; i < snakeCount; i++) {
+                for (unsigned int j = 0; j < snakeCount; j++) {
+                    if (i == j || !t_board.is_alive(i) || !t_board.is_alive(j)) continue;
+
+                    CellSet met = regions[i];
+                    met &= regions[j];
+                    CellSet entered = regions[i];
+                    entered &= bodies[j];
+                    if (met.any() || entered.any()) {
+                        return turn - 1;
+                    }
+                }
+            }
+        }
+
+        return ENDGAME_HORIZON;
+    }
+
+    unsigned int endgame_survival(EndgameSearch& t_search, unsigned int t_depth, unsigned int t_floor) {
+        if (t_depth == t_search.horizon) {
+            return t_depth;
+        }
+        if (++t_search.nodes > ENDGAME_NODE_LIMIT) {
+            t_search.exhausted = true;
+            return t_depth;
+        }
+
+        const unsigned int bound = endgame_bound(t_search, t_depth);
+        if (bound <= t_floor) {
+            return bound;
+        }
+
+        // Moves onto cells with the fewest open neighbours first, hugging
+        // walls finds long paths early and so tightens the floor
+        std::array<std::pair<unsigned int, Simulator::Direction>, 4> moves;
+        unsigned int moveCount = 0;
+        const EndgameSnake& snake = t_search.snake;
+        const unsigned int head = snake.body.back();
+        for (const Simulator::Direction move : DIRECTIONS_MAP) {
+            const unsigned int cell = t_search.board.geometry.neighbour(head, move);
+            if (cell == Simulator::OFF_BOARD || snake.walls.test(cell)) continue;
+
+            unsigned int open = 0;
+            for (const Simulator::Direction next : DIRECTIONS_MAP) {
+                const unsigned int neighbour = t_search.board.geometry.neighbour(cell, next);
+                if (neighbour != Simulator::OFF_BOARD && !snake.occupied.test(neighbour) && !snake.walls.test(neighbour)) {
+                    open++;
+                }
+            }
+            moves[moveCount++] = {open, move};
+        }
+        for (unsigned int i = 1; i < moveCount; i++) {
+            for (unsigned int j = i; j > 0 && moves[j] < moves[j - 1]; j--) {
+                std::swap(moves[j], moves[j - 1]);
+            }
+        }
+
+        unsigned int best = t_depth;
+        for (unsigned int i = 0; i < moveCount && best < bound; i++) {
+            EndgameUndo undo;
+            if (!endgame_make_move(t_search, moves[i].second, undo)) continue;
+
+            best = std::max(best, endgame_survival(t_search, t_depth + 1, std::max(best, t_floor)));
+            endgame_unmake_move(t_search, undo);
+
+            if (t_search.exhausted) break;
+        }
+
+        return best;
+    }
+
+    unsigned int endgame_bound(const EndgameSearch& t_search, unsigned int t_depth) {
+        const EndgameSnake& snake = t_search.snake;
+
+        // Segment k from the tail is gone after k + 1 turns without eating,
+        // eating only keeps segments longer. The head is on some cell of
+        // reach every turn, so once reach is empty the snake is dead.
+        CellSet blocked = snake.occupied;
+        blocked |= snake.walls;
+        CellSet reach;
+        reach.set(snake.body.back());
+        CellSet reached = reach;
+
+        unsigned int bound = t_search.horizon;
+        size_t segment = snake.tail;
+        for (unsigned int turn = 1; t_depth + turn <= t_search.horizon; turn++) {
+            if (segment < snake.body.size()) {
+                if (segment + 1 == snake.body.size() || snake.body[segment] != snake.body[segment + 1]) {
+                    blocked.reset(snake.body[segment]);
+                }
+                segment++;
+            }
+
+            reach = endgame_neighbours(t_search.board, reach);
+            reach.and_not(blocked);
+            if (!reach.any()) {
+                bound = t_depth + turn - 1;
+                break;
+            }
+            reached |= reach;
+        }
+
+        // Without food in reach the snake starves
+        reached &= t_search.food;
+        if (!reached.any()) {
+            bound = std::min(bound, t_depth + static_cast<unsigned int>(std::max(snake.health - 1, 0)));
+        }
+
+        return bound;
+    }
+
+    EndgameSnake endgame_make_snake(const Simulator::Board& t_board, const EndgameBoard& t_endgame, unsigned int t_index) {
+        const Simulator::Snake& snake = t_board.get_snake(t_index);
+
+        EndgameSnake result{{}, 0, {}, {}, snake.get_health()};
+        result.body.reserve(snake.get_length() + ENDGAME_HORIZON);
+        for (const Simulator::Position segment : snake) {
+            const unsigned int cell = t_endgame.geometry.to_cell(segment);
+            result.body.push_back(static_cast<uint16_t>(cell));
+            result.occupied.set(cell);
+        }
+
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (i == t_index || !t_board.is_alive(i)) continue;
+
+            for (const Simulator::Position segment : t_board.get_snake(i)) {
+                result.walls.set(t_endgame.geometry.to_cell(segment));
+            }
+        }
+
+        return result;
+    }
+
+    bool endgame_make_move(EndgameSearch& t_search, Simulator::Direction t_move, EndgameUndo& t_undo) {
+        EndgameSnake& snake = t_search.snake;
+
+        const unsigned int cell = t_search.board.geometry.neighbour(snake.body.back(), t_move);
+        if (cell == Simulator::OFF_BOARD || snake.walls.test(cell)) {
+            return false;
+        }
+
+        // As in Board::update a snake that eats keeps its tail, and the tail leaves before heads collide
+        const bool ate = t_search.food.test(cell);
+        const unsigned int tail = snake.body[snake.tail];
+        const bool tailLeaves = !ate && (snake.tail + 1 == snake.body.size() || snake.body[snake.tail + 1] != tail);
+        if (snake.occupied.test(cell) && !(tailLeaves && cell == tail)) {
+            return false;
+        }
+        if (!ate && snake.health <= 1) {
+            return false;
+        }
+
+        t_undo = EndgameUndo{ate, snake.health};
+        if (ate) {
+            t_search.food.reset(cell);
+            snake.health = t_search.board.maxHealth;
+        }
+        else {
+            if (tailLeaves) {
+                snake.occupied.reset(tail);
+            }
+            snake.tail++;
+            snake.health--;
+        }
+        snake.body.push_back(static_cast<uint16_t>(cell));
+        snake.occupied.set(cell);
+
+        return true;
+    }
+
+    void endgame_unmake_move(EndgameSearch& t_search, const EndgameUndo& t_undo) {
+        EndgameSnake& snake = t_search.snake;
+
+        const unsigned int cell = snake.body.back();
+        snake.body.pop_back();
+        snake.occupied.reset(cell);
+
+        if (t_undo.ate) {
+            t_search.food.set(cell);
+        }
+        else {
+            snake.tail--;
+            snake.occupied.set(snake.body[snake.tail]);
+        }
+        snake.health = t_undo.health;
+    }
+
+}
@@ -1,4 +1,7 @@
+#include <array>
 #include <iostream>
+#include <optional>
+#include <vector>
 
 #include "ai.hpp"
 #include "simulator.hpp"
@@ -6,49 +9,71 @@
 constexpr unsigned int ROUND_COUNT = 100;
 
 int main(int argc, char* argv[]) {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-        {"a", Simulator::Snake(Simulator::Position{1, 1}, 3, 100)},
-        {"b", Simulator::Snake(Simulator::Position{1, 9}, 3, 100)},
-        {"c", Simulator::Snake(Simulator::Position{9, 1}, 3, 100)},
-        {"d", Simulator::Snake(Simulator::Position{9, 9}, 3, 100)},
-    };
-
-    const std::unordered_map<std::string, float> ucbConstants {
-        {"a", 0.25f},
-        {"b", 0.50f},
-        {"c", 0.75f},
-        {"d", 1.00f}
-    };
-
-    std::unordered_map<std::string, unsigned int> winCounts;
+    // Given exactly two engines the rounds are duels from opposite corners
+    const bool duel = (argc == 3);
+    const std::vector<Simulator::Snake> snakes = duel
+        ? std::vector<Simulator::Snake> {
+            Simulator::Snake(Simulator::Position{1, 1}, 3, 100),
+            Simulator::Snake(Simulator::Position{9, 9}, 3, 100),
+        }
+        : std::vector<Simulator::Snake> {
+            Simulator::Snake(Simulator::Position{1, 1}, 3, 100),
+            Simulator::Snake(Simulator::Position{1, 9}, 3, 100),
+            Simulator::Snake(Simulator::Position{9, 1}, 3, 100),
+            Simulator::Snake(Simulator::Position{9, 9}, 3, 100),
+        };
+
+    // Snake i is played by the engine named by argument i + 1, suct by default
+    std::array<AI::Engine, 4> engines{AI::Engine::SUCT, AI::Engine::SUCT, AI::Engine::SUCT, AI::Engine::SUCT};
+    for (int i = 1; i < argc && i <= static_cast<int>(engines.size()); i++) {
+        const std::optional<AI::Engine> engine = AI::engine_from_string(argv[i]);
+        if (!engine) {
+            std::cerr << "Unknown engine '" << argv[i] << "', expected seek_food, suct, tree_suct, duct or alpha_beta\n";
+            return 1;
+        }
+        engines[i - 1] = *engine;
+    }
+
+    // Names are only used for output, snake i is player ids[i]
+    const std::array<std::string, 4> ids {"a", "b", "c", "d"};
+    const std::array<float, 4> ucbConstants {0.25f, 0.50f, 0.75f, 1.00f};
+
+    std::array<unsigned int, 4> winCounts{};
+
+    // Every search gets a different seed, a run is reproducible up to the compute time limit
+    uint64_t seed = 0;
 
     for (unsigned int i = 0; i < ROUND_COUNT; i++) {
         std::cout << "ROUND " << i << " START\n";
         const Simulator::FoodGrid food = {Grid<bool>(11, 11), 0};
-        Simulator::Board board{snakes, food};
+        Simulator::Board board{snakes, food, Simulator::DEFAULT_RULESET, i};
+
+        // Each player keeps its search tree between its moves in a round
+        std::array<AI::SearchTree, 4> trees;
 
         std::cout << board.to_string();
         while (!board.is_game_over()) {
-            std::unordered_map<std::string, Simulator::Direction> moveMap;
-            for (const auto&[id, s]: board.get_snakes()) {
+            Simulator::MoveArray moves{};
+            for (unsigned int j = 0; j < board.get_snake_count(); j++) {
+                if (!board.is_alive(j)) continue;
 
-                const Simulator::Direction move = AI::mcts_suct_player(board, id, {200, ucbConstants.at(id)});
-                std::cout << id << " chose '" << Simulator::direction_to_string(move) << "'\n";
-                moveMap[id] = move;
+                const Simulator::Direction move = AI::engine_player(engines[j], board, j, {200, ucbConstants[j], seed++}, &trees[j]);
+                std::cout << ids[j] << " chose '" << Simulator::direction_to_string(move) << "'\n";
+                moves[j] = move;
             }
             std::cout << '\n';
 
-            board.update(moveMap);
+            board.update(moves);
             std::cout << board.to_string();
         }
-        const std::string* winner = board.get_winner();
-        if (winner != nullptr) {
-            winCounts[*winner]++;
+        const unsigned int winner = board.get_winner();
+        if (winner < board.get_snake_count()) {
+            winCounts[winner]++;
         }
     }
 
-    for (const auto& [id, winCount] : winCounts) {
-        std::cout << id << ": " << winCount << " / " << ROUND_COUNT << '\n';
+    for (unsigned int i = 0; i < snakes.size(); i++) {
+        std::cout << ids[i] << ": " << winCounts[i] << " / " << ROUND_COUNT << '\n';
     }
 
     return 0;
@@ -1,71 +1,532 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <limits>
-#include <random>
-#include <unordered_map>
+#include <optional>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "ai.hpp"
+#include "arena.hpp"
+#include "transposition.hpp"
+#include "zobrist.hpp"
 
 #include <iostream>
 
 namespace AI {
 
-    static std::mt19937 rng(0);
-
-    using RewardMap = std::unordered_map<std::string, float>;
+    // The search runs on a BitBoard specialised for the size of the board,
+    // so everything below is templated on the BitBoard type
 
+    // The k-th player to choose a move is snake turnOrder[k] on the board
+    template <class BitBoard>
     struct State {
-        Simulator::Board board;
-        std::vector<std::string> turnOrder;
-        std::vector<Simulator::Direction> selectedMoves;
+        BitBoard board;
+        std::array<uint8_t, Simulator::MAX_SNAKES> turnOrder;
+        uint8_t playerCount;
+        std::array<Simulator::Direction, Simulator::MAX_SNAKES> selectedMoves; // Indexed by turn
+        uint8_t selectedCount;
 
-        friend bool operator==(const State& t_s1, const State& t_s2);
+        [[nodiscard]] unsigned int get_current_player() const;
     };
 
-    struct StateHash {
-        size_t operator()(const State& t_state) const noexcept;
-    };
+    // Outcome of a solved node, otherwise the index of the snake that wins
+    constexpr uint8_t OUTCOME_DRAW = Simulator::MAX_SNAKES;
+    constexpr uint8_t OUTCOME_UNSOLVED = Simulator::MAX_SNAKES + 1;
 
+    // Node of the search tree, one per decision of a single player. Nodes do
+    // not store their State, it is rebuilt by making the moves on the path
+    // from the root.
     struct Node {
-        unsigned int visitCount;
-        RewardMap rewards;
+        unsigned int visitCount = 0;
+        RewardArray rewards{};
+        std::array<Arena<Node>::Index, 4> children {Arena<Node>::NONE, Arena<Node>::NONE, Arena<Node>::NONE, Arena<Node>::NONE}; // Indexed by Direction
+        uint8_t outcome = OUTCOME_UNSOLVED; // Proven end of the game whatever is chosen below, see suct_solve_node
+    };
+
+    using NodeArena = Arena<Node>;
+    using NodeIndex = NodeArena::Index;
+
+    // Statistics of one decision kept in a transposition table instead of a
+    // node. They are held by the parent, per move, and the rewards are those
+    // of the player making the move.
+    struct SuctEntry {
+        unsigned int visitCount = 0;
+        std::array<unsigned int, 4> visits{}; // Indexed by Direction
+        std::array<float, 4> rewards{};
+
+        [[nodiscard]] unsigned int weight() const {
+            return visitCount;
+        }
+    };
+
+    using SuctTable = TranspositionTable<SuctEntry>;
+
+    // Table key of a decision, the entry holds the statistics of each move
+    // under the symmetry, so move m is found at transform_direction(symmetry, m)
+    struct SuctKey {
+        uint64_t hash;
+        unsigned int symmetry;
+    };
+
+    // Node of the single tree searched by every thread of a tree parallel
+    // search, the statistics are atomics so that threads update them without locks
+    struct SharedNode {
+        std::atomic<unsigned int> visitCount{0};
+        std::array<std::atomic<float>, Simulator::MAX_SNAKES> rewards{};
+        std::array<std::atomic<ConcurrentArena<SharedNode>::Index>, 4> children; // Indexed by Direction
+
+        SharedNode() {
+            for (auto& child : children) {
+                child.store(ConcurrentArena<SharedNode>::NONE, std::memory_order_relaxed);
+            }
+        }
     };
 
-    using NodeMap = std::unordered_map<State, Node, StateHash>;
+    using SharedArena = ConcurrentArena<SharedNode>;
+
+    // Once the shared tree is full leaves are played out without being stored
+    constexpr SharedArena::Index SHARED_TREE_CAPACITY = 1 << 19;
+
+    // Tree of the previous search of a SearchTree, along with the board and
+    // player it was searched for. Searches with a transposition table keep the table instead.
+    struct SuctTreeState {
+        NodeArena nodes;
+        NodeIndex root = NodeArena::NONE;
+        std::optional<Simulator::Board> board;
+        unsigned int playerIndex = 0;
+        std::optional<SuctTable> table;
+        unsigned int tableMegabytes = 0;
+        // Constructing every node takes a while, so tree parallel searches
+        // reuse the shared tree of the first one and only rebuild the nodes in use
+        std::unique_ptr<SharedArena> sharedNodes;
+    };
+
+    // Restores a State changed by suct_make_move, the board record is only
+    // used when the move completed a turn
+    template <class BitBoard>
+    struct StateUndo {
+        typename BitBoard::Undo board;
+        std::array<Simulator::Direction, Simulator::MAX_SNAKES> selectedMoves;
+        uint8_t selectedCount;
+    };
+
+    // Root statistics of one search, the rewards are those of the searching player
+    struct RootStats {
+        std::array<unsigned int, 4> visits{}; // Indexed by Direction
+        std::array<float, 4> rewards{};
+        std::array<std::optional<float>, 4> provenRewards{}; // Set for moves whose outcome is proven
+        uint64_t iterations = 0;
+        uint64_t nodes = 0;
+        TableStats table{};
+    };
 
-    State suct_from_board(const Simulator::Board& t_board, const std::string& t_playerId);
-    State suct_update_state(const State& t_state, Simulator::Direction t_move);
-    void suct_update_node(const State& t_state, NodeMap& t_nodes, const RewardMap& t_rewards);
+    using Clock = std::chrono::high_resolution_clock;
 
-    RewardMap suct_evaluate_state(const State& t_state);
-    RewardMap suct_mcts_rollout(const State& t_state);
+    // If t_tree is not null the first thread continues the search of its root
+    // and leaves its tree there, or searches with its table if the search uses one
+    template <class BitBoard>
+    Simulator::Direction suct_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats, SuctTreeState* t_tree);
+    template <class BitBoard>
+    RootStats suct_search_worker(State<BitBoard> t_state, unsigned int t_playerIndex, MCTSParameters t_params, uint64_t t_seed, Clock::time_point t_start, NodeArena& t_nodes, NodeIndex t_root);
 
-    std::vector<Simulator::Direction> suct_get_unselected_moves(const State& t_state, const NodeMap& t_nodes);
+    template <class BitBoard>
+    RootStats suct_table_worker(State<BitBoard> t_state, MCTSParameters t_params, uint64_t t_seed, Clock::time_point t_start, SuctTable& t_table);
+
+    // Searches below t_move at the root of t_tree, with its table if it has one
+    template <class BitBoard>
+    void suct_ponder(SuctTreeState& t_tree, Simulator::Direction t_move, MCTSParameters t_params, const std::atomic<bool>& t_stop, SearchStats* t_stats);
+
+    // Plays the endgame move or seek_food where mcts_suct_player would, and
+    // otherwise searches with t_nodes, or with a shared tree of its own if it is null
+    Simulator::Direction suct_tree_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats, SharedArena* t_nodes);
+    // Empties t_nodes before the search starts its clock
+    template <class BitBoard>
+    Simulator::Direction suct_tree_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats, SharedArena& t_nodes);
+    template <class BitBoard>
+    RootStats suct_tree_worker(State<BitBoard> t_state, SharedArena& t_nodes, NodeIndex t_root, MCTSParameters t_params, uint64_t t_seed, Clock::time_point t_start);
+
+    // Calls t_worker(thread, seed) on t_params.threadCount threads and sums the results
+    template <class Worker>
+    RootStats suct_run_workers(MCTSParameters t_params, Worker t_worker);
+
+    // The safe move with the best average reward at the root
+    template <class BitBoard>
+    Simulator::Direction suct_choose_move(const BitBoard& t_board, unsigned int t_playerIndex, const RootStats& t_root, SearchStats* t_stats);
+
+    // Moves t_tree to the node reached by the moves played since its search,
+    // or to a new tree if the node is missing or t_board is not the board reached
+    void suct_advance_tree(SuctTreeState& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex);
+    NodeIndex suct_find_played_node(const SuctTreeState& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex);
+    // Returns the index of the copy of t_root in t_to
+    NodeIndex suct_copy_subtree(const NodeArena& t_from, NodeIndex t_root, NodeArena& t_to);
+
+    template <class BitBoard>
+    State<BitBoard> suct_from_board(const Simulator::Board& t_board, unsigned int t_playerIndex);
+    template <class BitBoard>
+    StateUndo<BitBoard> suct_make_move(State<BitBoard>& t_state, Simulator::Direction t_move);
+    template <class BitBoard>
+    void suct_unmake_move(State<BitBoard>& t_state, const StateUndo<BitBoard>& t_undo);
+    // Same as suct_make_move for moves that are never unmade, without an undo record
+    template <class BitBoard>
+    void suct_play_move(State<BitBoard>& t_state, Simulator::Direction t_move);
+    void suct_update_node(Node& t_node, const RewardArray& t_rewards);
+
+    // Solves t_node from its children, if they prove an outcome. The first
+    // player of a turn, the searching player, knows everything that came
+    // before its choice, so it solves t_node with a child it wins, or once
+    // every child is solved with the best of them for it. Players of a turn
+    // choose at once but the tree orders them, so the later players are
+    // assumed to know its choice and solve t_node, once every child is
+    // solved, with the worst of them for the first player.
+    void suct_solve_node(NodeArena& t_nodes, NodeIndex t_node, const std::vector<Simulator::Direction>& t_safeMoves, unsigned int t_player, unsigned int t_firstPlayer);
+    RewardArray suct_outcome_rewards(uint8_t t_outcome);
+
+    template <class BitBoard>
+    RewardArray suct_evaluate_state(const State<BitBoard>& t_state);
+    template <class BitBoard>
+    RewardArray suct_mcts_rollout(const State<BitBoard>& t_state, MCTSParameters t_params, Simulator::Rng& t_rng);
+
+    // Safe moves of the current player that have no child yet
+    std::vector<Simulator::Direction> suct_get_unselected_moves(const std::vector<Simulator::Direction>& t_safeMoves, const Node& t_node);
 
     float suct_ucb(float t_reward, unsigned int t_n, unsigned int t_N, float t_c);
-    Simulator::Direction suct_select_move(const State& t_state, const NodeMap& t_nodes, MCTSParameters t_params);
+    Simulator::Direction suct_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const NodeArena& t_nodes, NodeIndex t_node, unsigned int t_playerIndex, MCTSParameters t_params);
+
+    // Leaves t_state unchanged when it returns
+    template <class BitBoard>
+    RootStats suct_tree_worker(State<BitBoard> t_state, SharedArena& t_nodes, NodeIndex t_root, MCTSParameters t_params, uint64_t t_seed, Clock::time_point t_start) {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+
+        Simulator::Rng rng(t_seed);
+
+        // Root statistics are read from the shared tree once every worker is done
+        RootStats result;
+        while (duration_cast<milliseconds>(Clock::now() - t_start).count() < t_params.computeTime) {
+            suct_tree_iter(t_state, t_nodes, t_root, t_params, rng);
+            result.iterations++;
+        }
+
+        return result;
+    }
+
+    template <class BitBoard>
+    RewardArray suct_mcts_iter(State<BitBoard>& t_state, NodeArena& t_nodes, NodeIndex t_node, MCTSParameters t_params, Simulator::Rng& t_rng);
+
+    // Same as suct_mcts_iter on the shared tree, safe to call from several threads at once
+    template <class BitBoard>
+    RewardArray suct_tree_iter(State<BitBoard>& t_state, SharedArena& t_nodes, NodeIndex t_node, MCTSParameters t_params, Simulator::Rng& t_rng);
+    Simulator::Direction suct_tree_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const SharedArena& t_nodes, NodeIndex t_node, unsigned int t_playerIndex, MCTSParameters t_params);
+    void suct_tree_update_node(SharedNode& t_node, const RewardArray& t_rewards);
+
+    // Same as suct_mcts_iter with the statistics of every decision in t_table, keyed by suct_state_key
+    template <class BitBoard>
+    RewardArray suct_table_iter(State<BitBoard>& t_state, SuctTable& t_table, MCTSParameters t_params, Simulator::Rng& t_rng);
+    Simulator::Direction suct_table_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const SuctEntry& t_entry, MCTSParameters t_params, Simulator::Rng& t_rng);
 
-    RewardMap suct_mcts_iter(const State& t_state, NodeMap& t_nodes, MCTSParameters t_params);
+    // Hash of the board and of the moves chosen so far in the turn, so that
+    // boards reached by different moves share their statistics
+    template <class BitBoard>
+    uint64_t suct_state_key(const State<BitBoard>& t_state);
+    // With t_params.symmetry, the smallest suct_state_key of the images of
+    // t_state under the symmetries of the board, so that rotations and
+    // reflections of a position share their statistics
+    template <class BitBoard>
+    SuctKey suct_table_key(const State<BitBoard>& t_state, MCTSParameters t_params);
 
 
-    Simulator::Direction mcts_suct_player(const Simulator::Board& t_board, const std::string& t_playerId, MCTSParameters t_params) {
+    Simulator::Direction mcts_suct_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats) {
+        if (const std::optional<Simulator::Direction> move = endgame_player(t_board, t_playerIndex, t_stats)) {
+            return *move;
+        }
+
+        if (!Simulator::BitBoard::is_supported(t_board)) {
+            if (t_stats != nullptr) {
+                *t_stats = SearchStats{};
+            }
+
+            Simulator::Rng rng(t_params.seed);
+            return seek_food_player(t_board, t_playerIndex, rng);
+        }
+
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        return Simulator::dispatch_geometry(ruleset.w, ruleset.h, [&](auto t_geometry) {
+            return suct_search<Simulator::BasicBitBoard<decltype(t_geometry)>>(t_board, t_playerIndex, t_params, t_stats, nullptr);
+        });
+    }
+
+    Simulator::Direction mcts_suct_player(SearchTree& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats) {
+        SuctTreeState& tree = *t_tree.m_state;
+        if (!Simulator::BitBoard::is_supported(t_board)) {
+            tree.board.reset();
+            return mcts_suct_player(t_board, t_playerIndex, t_params, t_stats);
+        }
+
+        // Solved without the tree, which then has nothing to continue from
+        if (const std::optional<Simulator::Direction> move = endgame_player(t_board, t_playerIndex, t_stats)) {
+            tree.board.reset();
+            return *move;
+        }
+
+        if (t_params.tableMegabytes != 0) {
+            // Entries of earlier searches are found by position, so there is no tree to advance
+            if (!tree.table || tree.tableMegabytes != t_params.tableMegabytes) {
+                tree.table.emplace(t_params.tableMegabytes);
+                tree.tableMegabytes = t_params.tableMegabytes;
+            }
+            tree.table->new_search();
+        }
+        else {
+            suct_advance_tree(tree, t_board, t_playerIndex);
+        }
+
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        const Simulator::Direction move = Simulator::dispatch_geometry(ruleset.w, ruleset.h, [&](auto t_geometry) {
+            return suct_search<Simulator::BasicBitBoard<decltype(t_geometry)>>(t_board, t_playerIndex, t_params, t_stats, &tree);
+        });
+
+        tree.board = t_board;
+        tree.playerIndex = t_playerIndex;
+
+        return move;
+    }
+
+    void mcts_suct_ponder(SearchTree& t_tree, Simulator::Direction t_move, MCTSParameters t_params, const std::atomic<bool>& t_stop, SearchStats* t_stats) {
+        SuctTreeState& tree = *t_tree.m_state;
+
+        // Nothing to ponder if the last search fell back to seek_food
+        if (!tree.board) {
+            if (t_stats != nullptr) {
+                *t_stats = SearchStats{};
+            }
+            return;
+        }
+
+        const Simulator::Ruleset ruleset = tree.board->get_ruleset();
+        Simulator::dispatch_geometry(ruleset.w, ruleset.h, [&](auto t_geometry) {
+            suct_ponder<Simulator::BasicBitBoard<decltype(t_geometry)>>(tree, t_move, t_params, t_stop, t_stats);
+        });
+    }
+
+    SearchTree::SearchTree()
+        : m_state(std::make_unique<SuctTreeState>())
+    {
+        ;
+    }
+
+    SearchTree::~SearchTree() = default;
+
+    SearchTree::SearchTree(SearchTree&& t_other) noexcept = default;
+    SearchTree& SearchTree::operator=(SearchTree&& t_other) noexcept = default;
+
+    size_t SearchTree::size() const {
+        if (m_state->table) {
+            return m_state->table->get_stats().used;
+        }
+        return m_state->nodes.size();
+    }
+
+    Simulator::Direction mcts_tree_suct_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats) {
+        return suct_tree_player(t_board, t_playerIndex, t_params, t_stats, nullptr);
+    }
+
+    Simulator::Direction mcts_tree_suct_player(SearchTree& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats) {
+        SuctTreeState& tree = *t_tree.m_state;
+
+        // Nothing is kept between moves, so there is nothing to ponder either
+        tree.board.reset();
+        if (!tree.sharedNodes) {
+            tree.sharedNodes = std::make_unique<SharedArena>(SHARED_TREE_CAPACITY);
+        }
+
+        return suct_tree_player(t_board, t_playerIndex, t_params, t_stats, tree.sharedNodes.get());
+    }
+
+    Simulator::Direction suct_tree_player(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats, SharedArena* t_nodes) {
+        if (const std::optional<Simulator::Direction> move = endgame_player(t_board, t_playerIndex, t_stats)) {
+            return *move;
+        }
+
+        if (!Simulator::BitBoard::is_supported(t_board)) {
+            if (t_stats != nullptr) {
+                *t_stats = SearchStats{};
+            }
+
+            Simulator::Rng rng(t_params.seed);
+            return seek_food_player(t_board, t_playerIndex, rng);
+        }
+
+        // A tree of its own is freed when the search returns
+        std::unique_ptr<SharedArena> ownNodes;
+        if (t_nodes == nullptr) {
+            ownNodes = std::make_unique<SharedArena>(SHARED_TREE_CAPACITY);
+            t_nodes = ownNodes.get();
+        }
+
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        return Simulator::dispatch_geometry(ruleset.w, ruleset.h, [&](auto t_geometry) {
+            return suct_tree_search<Simulator::BasicBitBoard<decltype(t_geometry)>>(t_board, t_playerIndex, t_params, t_stats, *t_nodes);
+        });
+    }
+
+    template <class BitBoard>
+    Simulator::Direction suct_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats, SuctTreeState* t_tree) {
+        const Clock::time_point t1 = Clock::now();
+
+        const State<BitBoard> state = suct_from_board<BitBoard>(t_board, t_playerIndex);
+
+        // Root parallelism: every thread searches its own tree and the root statistics are summed
+        const RootStats root = suct_run_workers(t_params, [&](unsigned int t_thread, uint64_t t_seed) {
+            if (t_params.tableMegabytes != 0) {
+                if (t_thread == 0 && t_tree != nullptr) {
+                    return suct_table_worker(state, t_params, t_seed, t1, *t_tree->table);
+                }
+
+                SuctTable table(t_params.tableMegabytes);
+                return suct_table_worker(state, t_params, t_seed, t1, table);
+            }
+
+            if (t_thread == 0 && t_tree != nullptr) {
+                return suct_search_worker(state, t_playerIndex, t_params, t_seed, t1, t_tree->nodes, t_tree->root);
+            }
+
+            // The whole tree is freed with the arena when the search returns
+            NodeArena nodes(1 << 16);
+            const NodeIndex root = nodes.allocate();
+            return suct_search_worker(state, t_playerIndex, t_params, t_seed, t1, nodes, root);
+        });
+
+        return suct_choose_move(state.board, t_playerIndex, root, t_stats);
+    }
+
+    template <class BitBoard>
+    Simulator::Direction suct_tree_search(const Simulator::Board& t_board, unsigned int t_playerIndex, MCTSParameters t_params, SearchStats* t_stats, SharedArena& t_nodes) {
+        t_nodes.reset();
+        const Clock::time_point t1 = Clock::now();
+
+        const State<BitBoard> state = suct_from_board<BitBoard>(t_board, t_playerIndex);
+
+        // Tree parallelism: every thread makes its own moves on its own copy
+        // of the state but they all descend and grow the same tree
+        const NodeIndex root = t_nodes.allocate();
+
+        RootStats result = suct_run_workers(t_params, [&](unsigned int, uint64_t t_seed) {
+            return suct_tree_worker(state, t_nodes, root, t_params, t_seed, t1);
+        });
+
+        // Every thread has finished, so the statistics are final
+        for (unsigned int i = 0; i < 4; i++) {
+            const NodeIndex child = t_nodes[root].children[i].load(std::memory_order_relaxed);
+            if (child != SharedArena::NONE) {
+                result.visits[i] = t_nodes[child].visitCount.load(std::memory_order_relaxed);
+                result.rewards[i] = t_nodes[child].rewards[t_playerIndex].load(std::memory_order_relaxed);
+            }
+        }
+        result.nodes = t_nodes.size();
+
+        return suct_choose_move(state.board, t_playerIndex, result, t_stats);
+    }
+
+    template <class BitBoard>
+    void suct_ponder(SuctTreeState& t_tree, Simulator::Direction t_move, MCTSParameters t_params, const std::atomic<bool>& t_stop, SearchStats* t_stats) {
         using std::chrono::duration_cast;
-        using std::chrono::high_resolution_clock;
         using std::chrono::milliseconds;
-        
-        const auto t1 = high_resolution_clock::now();
-        
-        const State state = suct_from_board(t_board, t_playerId);
-        
-        NodeMap nodes;
-        nodes[state] = Node{0, {}};
 
-        while (duration_cast<milliseconds>(high_resolution_clock::now() - t1).count() < t_params.computeTime) {
-            suct_mcts_iter(state, nodes, t_params);
+        const Clock::time_point t1 = Clock::now();
+
+        // The other players choose next, from the node below t_move
+        State<BitBoard> state = suct_from_board<BitBoard>(*t_tree.board, t_tree.playerIndex);
+        suct_play_move(state, t_move);
+
+        const auto pondering = [&]() {
+            if (t_stop.load(std::memory_order_relaxed) || state.board.is_game_over()) {
+                return false;
+            }
+            return duration_cast<milliseconds>(Clock::now() - t1).count() < t_params.computeTime;
+        };
+
+        Simulator::Rng rng(t_params.seed);
+        uint64_t iterations = 0;
+        uint64_t nodes = 0;
+        TableStats table{};
+
+        if (t_tree.table) {
+            state.board.track_symmetric_hashes(t_params.symmetry);
+            while (pondering()) {
+                suct_table_iter(state, *t_tree.table, t_params, rng);
+                iterations++;
+            }
+            table = t_tree.table->get_stats();
+            nodes = table.used;
+        }
+        else {
+            NodeIndex node = t_tree.nodes[t_tree.root].children[static_cast<unsigned int>(t_move)];
+            if (node == NodeArena::NONE) {
+                node = t_tree.nodes.allocate();
+                t_tree.nodes[t_tree.root].children[static_cast<unsigned int>(t_move)] = node;
+            }
+
+            while (pondering() && t_tree.nodes[node].outcome == OUTCOME_UNSOLVED) {
+                suct_mcts_iter(state, t_tree.nodes, node, t_params, rng);
+                iterations++;
+            }
+            nodes = t_tree.nodes.size();
         }
 
-        const std::vector<Simulator::Direction> safeMoves = get_safe_moves(t_board, t_playerId);
+        if (t_stats != nullptr) {
+            *t_stats = SearchStats{iterations, nodes, table};
+        }
+    }
+
+    template <class Worker>
+    RootStats suct_run_workers(MCTSParameters t_params, Worker t_worker) {
+        // Thread 0 keeps the seed so that a single threaded search is unchanged
+        const unsigned int threadCount = std::max(t_params.threadCount, 1u);
+        std::vector<RootStats> results(threadCount);
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1);
+        for (unsigned int i = 1; i < threadCount; i++) {
+            const uint64_t seed = t_params.seed + i * 0x9E3779B97F4A7C15ull;
+            workers.emplace_back([&results, &t_worker, seed, i]() {
+                results[i] = t_worker(i, seed);
+            });
+        }
+        results[0] = t_worker(0, t_params.seed);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        RootStats merged;
+        for (const RootStats& result : results) {
+            for (unsigned int i = 0; i < 4; i++) {
+                merged.visits[i] += result.visits[i];
+                merged.rewards[i] += result.rewards[i];
+                if (result.provenRewards[i]) {
+                    merged.provenRewards[i] = result.provenRewards[i];
+                }
+            }
+            merged.iterations += result.iterations;
+            merged.nodes += result.nodes;
+            merged.table.capacity += result.table.capacity;
+            merged.table.used += result.table.used;
+            merged.table.probes += result.table.probes;
+            merged.table.hits += result.table.hits;
+            merged.table.collisions += result.table.collisions;
+        }
+
+        return merged;
+    }
+
+    template <class BitBoard>
+    Simulator::Direction suct_choose_move(const BitBoard& t_board, unsigned int t_playerIndex, const RootStats& t_root, SearchStats* t_stats) {
+        if (t_stats != nullptr) {
+            *t_stats = SearchStats{t_root.iterations, t_root.nodes, t_root.table};
+        }
+
+        const std::vector<Simulator::Direction> safeMoves = get_safe_moves(t_board, t_playerIndex);
         if (safeMoves.empty()) {
             return Simulator::Direction::UP;
         }
@@ -73,13 +534,12 @@ namespace AI {
         Simulator::Direction bestMove = safeMoves[0];
         float bestMoveScore = -std::numeric_limits<float>::infinity();
         for (Simulator::Direction move : safeMoves) {
-            const State nextState = suct_update_state(state, move);
-
-            const float totalReward = nodes[nextState].rewards[t_playerId];
-            const unsigned int visitCount = nodes[nextState].visitCount;
+            const float totalReward = t_root.rewards[static_cast<unsigned int>(move)];
+            const unsigned int visitCount = t_root.visits[static_cast<unsigned int>(move)];
+            const std::optional<float> provenReward = t_root.provenRewards[static_cast<unsigned int>(move)];
 
             if (visitCount != 0) {
-                const float score = totalReward / static_cast<float>(visitCount);
+                const float score = provenReward ? *provenReward : totalReward / static_cast<float>(visitCount);
                 if (score > bestMoveScore) {
                     bestMove = move;
                     bestMoveScore = score;
@@ -87,133 +547,527 @@ namespace AI {
             }
         }
 
-        // std::cout << "Nodes visited: " << nodes.size() << '\n';
+        // std::cout << "Nodes visited: " << t_root.nodes << '\n';
 
         return bestMove;
     }
 
-    RewardMap suct_mcts_iter(const State& t_state, NodeMap& t_nodes, MCTSParameters t_params) {
+    template <class BitBoard>
+    RootStats suct_search_worker(State<BitBoard> t_state, unsigned int t_playerIndex, MCTSParameters t_params, uint64_t t_seed, Clock::time_point t_start, NodeArena& t_nodes, NodeIndex t_root) {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+
+        Simulator::Rng rng(t_seed);
+
+        // Once the root is solved more iterations cannot change the move
+        RootStats result;
+        while (t_nodes[t_root].outcome == OUTCOME_UNSOLVED && duration_cast<milliseconds>(Clock::now() - t_start).count() < t_params.computeTime) {
+            suct_mcts_iter(t_state, t_nodes, t_root, t_params, rng);
+            result.iterations++;
+        }
+
+        for (unsigned int i = 0; i < 4; i++) {
+            const NodeIndex child = t_nodes[t_root].children[i];
+            if (child != NodeArena::NONE) {
+                result.visits[i] = t_nodes[child].visitCount;
+                result.rewards[i] = t_nodes[child].rewards[t_playerIndex];
+                // A draw and a loss are both worth nothing, but a proven loss is never worth playing
+                const uint8_t outcome = t_nodes[child].outcome;
+                if (outcome == OUTCOME_DRAW || outcome == t_playerIndex) {
+                    result.provenRewards[i] = suct_outcome_rewards(outcome)[t_playerIndex];
+                }
+                else if (outcome != OUTCOME_UNSOLVED) {
+                    result.provenRewards[i] = -1.0f;
+                }
+            }
+        }
+        result.nodes = t_nodes.size();
+
+        return result;
+    }
+
+    template <class BitBoard>
+    RootStats suct_table_worker(State<BitBoard> t_state, MCTSParameters t_params, uint64_t t_seed, Clock::time_point t_start, SuctTable& t_table) {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+
+        Simulator::Rng rng(t_seed);
+        t_state.board.track_symmetric_hashes(t_params.symmetry);
+
+        RootStats result;
+        while (duration_cast<milliseconds>(Clock::now() - t_start).count() < t_params.computeTime) {
+            suct_table_iter(t_state, t_table, t_params, rng);
+            result.iterations++;
+        }
+
+        // The root has the most visits of the search, so it is only lost if its bucket is full of busier entries
+        const SuctKey key = suct_table_key(t_state, t_params);
+        const SuctEntry* root = t_table.probe(key.hash);
+        if (root != nullptr) {
+            for (const Simulator::Direction move : DIRECTIONS_MAP) {
+                const unsigned int stored = static_cast<unsigned int>(Simulator::transform_direction(key.symmetry, move));
+                result.visits[static_cast<unsigned int>(move)] = root->visits[stored];
+                result.rewards[static_cast<unsigned int>(move)] = root->rewards[stored];
+            }
+        }
+        result.table = t_table.get_stats();
+        result.nodes = result.table.used;
+
+        return result;
+    }
+
+    template <class BitBoard>
+    RewardArray suct_mcts_iter(State<BitBoard>& t_state, NodeArena& t_nodes, NodeIndex t_node, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        if (t_nodes[t_node].outcome == OUTCOME_UNSOLVED && t_state.board.is_game_over()) {
+            const unsigned int winner = t_state.board.get_winner();
+            t_nodes[t_node].outcome = (winner < t_state.board.get_snake_count()) ? winner : OUTCOME_DRAW;
+        }
+
+        // A solved subtree is not sampled again, its outcome is backed up as it is
+        if (t_nodes[t_node].outcome != OUTCOME_UNSOLVED) {
+            const RewardArray rewards = suct_outcome_rewards(t_nodes[t_node].outcome);
+            suct_update_node(t_nodes[t_node], rewards);
+            return rewards;
+        }
+
+        const unsigned int currentPlayerIndex = t_state.get_current_player();
+        const std::vector<Simulator::Direction> safeMoves = get_safe_moves(t_state.board, currentPlayerIndex);
+        const std::vector<Simulator::Direction> unselectedMoves = suct_get_unselected_moves(safeMoves, t_nodes[t_node]);
+
+        // Allocating may move the nodes, so they are only ever held by index
+        if (!unselectedMoves.empty()) {
+            const Simulator::Direction move = unselectedMoves[t_rng.below(unselectedMoves.size())];
+
+            const StateUndo<BitBoard> undo = suct_make_move(t_state, move);
+            const RewardArray rewards = suct_mcts_rollout(t_state, t_params, t_rng);
+            const bool gameOver = t_state.board.is_game_over();
+            const unsigned int winner = t_state.board.get_winner();
+            suct_unmake_move(t_state, undo);
+
+            const NodeIndex child = t_nodes.allocate();
+            t_nodes[child].rewards = rewards;
+            t_nodes[child].visitCount = 1;
+            if (gameOver) {
+                t_nodes[child].outcome = (winner < t_state.board.get_snake_count()) ? winner : OUTCOME_DRAW;
+            }
+            t_nodes[t_node].children[static_cast<unsigned int>(move)] = child;
+
+            suct_update_node(t_nodes[t_node], rewards);
+            suct_solve_node(t_nodes, t_node, safeMoves, currentPlayerIndex, t_state.turnOrder[0]);
+
+            return rewards;
+        }
+        else {
+            const Simulator::Direction move = suct_select_move(safeMoves, t_nodes, t_node, currentPlayerIndex, t_params);
+
+            // Without a safe move the player is stepped into its death, whose node may not exist yet
+            NodeIndex child = t_nodes[t_node].children[static_cast<unsigned int>(move)];
+            if (child == NodeArena::NONE) {
+                child = t_nodes.allocate();
+                t_nodes[t_node].children[static_cast<unsigned int>(move)] = child;
+            }
+
+            const StateUndo<BitBoard> undo = suct_make_move(t_state, move);
+            const RewardArray rewards = suct_mcts_iter(t_state, t_nodes, child, t_params, t_rng);
+            suct_unmake_move(t_state, undo);
+
+            suct_update_node(t_nodes[t_node], rewards);
+            suct_solve_node(t_nodes, t_node, safeMoves, currentPlayerIndex, t_state.turnOrder[0]);
+
+            return rewards;
+        }
+    }
+
+
+    template <class BitBoard>
+    RewardArray suct_tree_iter(State<BitBoard>& t_state, SharedArena& t_nodes, NodeIndex t_node, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        // Visits are counted on the way down and rewards on the way back up.
+        // Until a thread returns, the other threads see its visit as a loss
+        // for every player, a virtual loss that spreads them over the tree.
+        t_nodes[t_node].visitCount.fetch_add(1, std::memory_order_relaxed);
+
+        RewardArray rewards;
         if (t_state.board.is_game_over()) {
-            return suct_evaluate_state(t_state);
+            rewards = suct_evaluate_state(t_state);
         }
         else {
-            const std::vector<Simulator::Direction> unselectedMoves = suct_get_unselected_moves(t_state, t_nodes);
+            const unsigned int currentPlayerIndex = t_state.get_current_player();
+            const std::vector<Simulator::Direction> safeMoves = get_safe_moves(t_state.board, currentPlayerIndex);
 
-            if (t_nodes.count(t_state) && !unselectedMoves.empty()) {
-                const Simulator::Direction move = unselectedMoves[rng() % unselectedMoves.size()];
+            std::vector<Simulator::Direction> unselectedMoves;
+            for (const Simulator::Direction move : safeMoves) {
+                if (t_nodes[t_node].children[static_cast<unsigned int>(move)].load(std::memory_order_acquire) == SharedArena::NONE) {
+                    unselectedMoves.push_back(move);
+                }
+            }
 
-                const State newState = suct_update_state(t_state, move);
+            const Simulator::Direction move = unselectedMoves.empty()
+                ? suct_tree_select_move(safeMoves, t_nodes, t_node, currentPlayerIndex, t_params)
+                : unselectedMoves[t_rng.below(unselectedMoves.size())];
 
-                RewardMap rewards = suct_mcts_rollout(newState);
-                t_nodes[newState].rewards = rewards;
-                t_nodes[newState].visitCount++;
+            // A new node is linked in with a compare and swap, if another
+            // thread links one first that node is used and ours is left unused
+            std::atomic<NodeIndex>& link = t_nodes[t_node].children[static_cast<unsigned int>(move)];
+            NodeIndex child = link.load(std::memory_order_acquire);
+            bool created = false;
+            if (child == SharedArena::NONE) {
+                child = t_nodes.allocate();
+                if (child != SharedArena::NONE) {
+                    t_nodes[child].visitCount.store(1, std::memory_order_relaxed);
 
-                suct_update_node(t_state, t_nodes, rewards);
+                    NodeIndex expected = SharedArena::NONE;
+                    created = link.compare_exchange_strong(expected, child, std::memory_order_acq_rel);
+                    if (!created) {
+                        child = expected;
+                    }
+                }
+            }
 
-                return rewards;
+            const StateUndo<BitBoard> undo = suct_make_move(t_state, move);
+            if (child == SharedArena::NONE) {
+                rewards = suct_mcts_rollout(t_state, t_params, t_rng);
+            }
+            else if (created) {
+                rewards = suct_mcts_rollout(t_state, t_params, t_rng);
+                suct_tree_update_node(t_nodes[child], rewards);
             }
             else {
-                const Simulator::Direction move = suct_select_move(t_state, t_nodes, t_params);
-                const State newState = suct_update_state(t_state, move);
+                rewards = suct_tree_iter(t_state, t_nodes, child, t_params, t_rng);
+            }
+            suct_unmake_move(t_state, undo);
+        }
+
+        suct_tree_update_node(t_nodes[t_node], rewards);
 
-                RewardMap rewards = suct_mcts_iter(newState, t_nodes, t_params);
-                suct_update_node(t_state, t_nodes, rewards);
+        return rewards;
+    }
 
-                return rewards;
+    template <class BitBoard>
+    RewardArray suct_table_iter(State<BitBoard>& t_state, SuctTable& t_table, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        if (t_state.board.is_game_over()) {
+            return suct_evaluate_state(t_state);
+        }
+
+        // As in the tree, one decision is added per iteration and scored with a rollout
+        const SuctKey key = suct_table_key(t_state, t_params);
+        const SuctEntry* entry = t_table.probe(key.hash);
+        if (entry == nullptr) {
+            t_table.store(key.hash).visitCount = 1;
+            return suct_mcts_rollout(t_state, t_params, t_rng);
+        }
+
+        // Moves are chosen as the entry stores them and played on the board as they are
+        const unsigned int currentPlayerIndex = t_state.get_current_player();
+        std::vector<Simulator::Direction> safeMoves = get_safe_moves(t_state.board, currentPlayerIndex);
+        for (Simulator::Direction& safeMove : safeMoves) {
+            safeMove = Simulator::transform_direction(key.symmetry, safeMove);
+        }
+        const Simulator::Direction stored = suct_table_select_move(safeMoves, *entry, t_params, t_rng);
+        const Simulator::Direction move = Simulator::transform_direction(Simulator::inverse_symmetry(key.symmetry), stored);
+
+        const StateUndo<BitBoard> undo = suct_make_move(t_state, move);
+        const RewardArray rewards = suct_table_iter(t_state, t_table, t_params, t_rng);
+        suct_unmake_move(t_state, undo);
+
+        // Stores below may have replaced the entry, in which case it starts over
+        SuctEntry& updated = t_table.store(key.hash);
+        updated.visitCount++;
+        updated.visits[static_cast<unsigned int>(stored)]++;
+        updated.rewards[static_cast<unsigned int>(stored)] += rewards[currentPlayerIndex];
+
+        return rewards;
+    }
+
+    template <class BitBoard>
+    uint64_t suct_state_key(const State<BitBoard>& t_state) {
+        uint64_t result = t_state.board.get_hash();
+        for (unsigned int i = 0; i < t_state.selectedCount; i++) {
+            result ^= Simulator::Zobrist::move(i, t_state.selectedMoves[i]);
+        }
+        return result;
+    }
+
+    template <class BitBoard>
+    SuctKey suct_table_key(const State<BitBoard>& t_state, MCTSParameters t_params) {
+        if (!t_params.symmetry) {
+            return SuctKey{suct_state_key(t_state), Simulator::IDENTITY_SYMMETRY};
+        }
+
+        // Ties between symmetries go to the first, so a position always picks the same one
+        const Simulator::Ruleset ruleset = t_state.board.get_ruleset();
+        const std::array<uint64_t, Simulator::SYMMETRY_COUNT> hashes = t_state.board.get_symmetric_hashes();
+        SuctKey result{UINT64_MAX, Simulator::IDENTITY_SYMMETRY};
+        for (unsigned int s = 0; s < Simulator::get_symmetry_count(ruleset.w, ruleset.h); s++) {
+            uint64_t hash = hashes[s];
+            for (unsigned int i = 0; i < t_state.selectedCount; i++) {
+                hash ^= Simulator::Zobrist::move(i, Simulator::transform_direction(s, t_state.selectedMoves[i]));
+            }
+            if (s == 0 || hash < result.hash) {
+                result = SuctKey{hash, s};
             }
         }
+        return result;
     }
 
+    void suct_advance_tree(SuctTreeState& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex) {
+        const NodeIndex played = suct_find_played_node(t_tree, t_board, t_playerIndex);
 
-    State suct_from_board(const Simulator::Board& t_board, const std::string& t_playerId) {
-        const auto& snakes = t_board.get_snakes();
-                
-        std::vector<std::string> turnOrder;
-        turnOrder.reserve(snakes.size());
-        
-        // Make SUCT player move first to promote defensive play
-        turnOrder.push_back(t_playerId);
-                
-        for (const auto& [id, snake] : snakes) {
-            if (id != t_playerId) {
-                turnOrder.push_back(id);
+        NodeArena kept(std::max<size_t>(t_tree.nodes.size(), 1 << 16));
+        t_tree.root = (played != NodeArena::NONE) ? suct_copy_subtree(t_tree.nodes, played, kept) : kept.allocate();
+        t_tree.nodes = std::move(kept);
+    }
+
+    NodeIndex suct_find_played_node(const SuctTreeState& t_tree, const Simulator::Board& t_board, unsigned int t_playerIndex) {
+        if (!t_tree.board || t_tree.root == NodeArena::NONE || t_tree.playerIndex != t_playerIndex) {
+            return NodeArena::NONE;
+        }
+
+        const Simulator::Board& previous = *t_tree.board;
+        if (previous.get_snake_count() != t_board.get_snake_count()) {
+            return NodeArena::NONE;
+        }
+
+        // The moves played are the steps from the previous heads to the current
+        // ones. The tree only holds the players that were alive, so any
+        // elimination changes the order players move in and the tree is dropped.
+        Simulator::MoveArray moves{};
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (previous.is_alive(i) != t_board.is_alive(i)) {
+                return NodeArena::NONE;
+            }
+            if (!t_board.is_alive(i)) continue;
+
+            const Simulator::Position head = previous.get_snake(i).get_head();
+            const auto it = std::find_if(DIRECTIONS_MAP.begin(), DIRECTIONS_MAP.end(), [&](Simulator::Direction t_move) {
+                return Simulator::update_position(head, t_move) == t_board.get_snake(i).get_head();
+            });
+            if (it == DIRECTIONS_MAP.end()) {
+                return NodeArena::NONE;
+            }
+            moves[i] = *it;
+        }
+
+        // Food does not spawn in the search, so if any spawned the board differs and the tree is dropped
+        Simulator::Ruleset ruleset = previous.get_ruleset();
+        ruleset.spawnFood = false;
+        Simulator::Board expected{previous, ruleset};
+        expected.update(moves);
+        if (expected.get_hash() != t_board.get_hash()) {
+            return NodeArena::NONE;
+        }
+
+        // Players move in the order of suct_from_board
+        NodeIndex node = t_tree.root;
+        const auto descend = [&](unsigned int t_index) {
+            if (node != NodeArena::NONE) {
+                node = t_tree.nodes[node].children[static_cast<unsigned int>(moves[t_index])];
+            }
+        };
+        descend(t_playerIndex);
+        for (unsigned int i = 0; i < previous.get_snake_count(); i++) {
+            if (i != t_playerIndex && previous.is_alive(i)) {
+                descend(i);
             }
         }
-        
+
+        return node;
+    }
+
+    NodeIndex suct_copy_subtree(const NodeArena& t_from, NodeIndex t_root, NodeArena& t_to) {
+        // Nodes are copied with the child indices of t_from, which are
+        // replaced with those of the copied children when the node is popped
+        std::vector<std::pair<NodeIndex, NodeIndex>> stack;
+
+        const NodeIndex root = t_to.allocate();
+        t_to[root] = t_from[t_root];
+        stack.emplace_back(t_root, root);
+
+        while (!stack.empty()) {
+            const auto [from, to] = stack.back();
+            stack.pop_back();
+
+            for (unsigned int i = 0; i < 4; i++) {
+                const NodeIndex child = t_from[from].children[i];
+                if (child == NodeArena::NONE) continue;
+
+                const NodeIndex copy = t_to.allocate();
+                t_to[copy] = t_from[child];
+                t_to[to].children[i] = copy;
+                stack.emplace_back(child, copy);
+            }
+        }
+
+        return root;
+    }
+
+    template <class BitBoard>
+    State<BitBoard> suct_from_board(const Simulator::Board& t_board, unsigned int t_playerIndex) {
         // Disable food spawning in search to reduce the number of nodes to be visited
         Simulator::Ruleset ruleset = t_board.get_ruleset();
         ruleset.spawnFood = false;
-        return State{Simulator::Board{t_board, ruleset}, turnOrder, {}};
+
+        State<BitBoard> result{BitBoard{Simulator::Board{t_board, ruleset}}, {}, 0, {}, 0};
+
+        // Make SUCT player move first to promote defensive play
+        result.turnOrder[result.playerCount++] = t_playerIndex;
+
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (i != t_playerIndex && t_board.is_alive(i)) {
+                result.turnOrder[result.playerCount++] = i;
+            }
+        }
+
+        return result;
     }
-    
-    State suct_update_state(const State& t_state, Simulator::Direction t_move) {
-        std::vector<Simulator::Direction> selectedMovesNew = t_state.selectedMoves;
-        selectedMovesNew.push_back(t_move);
-        
-        if (selectedMovesNew.size() == t_state.turnOrder.size()) {
-            std::unordered_map<std::string, Simulator::Direction> moves;
-            for (unsigned int i = 0; i < t_state.turnOrder.size(); i++) {
-                moves[t_state.turnOrder[i]] = selectedMovesNew[i];
+
+    template <class BitBoard>
+    StateUndo<BitBoard> suct_make_move(State<BitBoard>& t_state, Simulator::Direction t_move) {
+        StateUndo<BitBoard> undo{{}, t_state.selectedMoves, t_state.selectedCount};
+
+        t_state.selectedMoves[t_state.selectedCount++] = t_move;
+
+        if (t_state.selectedCount == t_state.playerCount) {
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < t_state.playerCount; i++) {
+                moves[t_state.turnOrder[i]] = t_state.selectedMoves[i];
             }
-            Simulator::Board boardNew = t_state.board;
-            boardNew.update(moves);
-            
-            return State{boardNew, t_state.turnOrder, {}};
+
+            undo.board = t_state.board.make_move(moves);
+            t_state.selectedMoves = {};
+            t_state.selectedCount = 0;
         }
-        
-        return State{t_state.board, t_state.turnOrder, selectedMovesNew};
+
+        return undo;
     }
 
-    void suct_update_node(const State& t_state, NodeMap& t_nodes, const RewardMap& t_rewards) {
-        for (const auto& [id, r] : t_rewards) {
-            t_nodes[t_state].rewards[id] += r;
+    template <class BitBoard>
+    void suct_unmake_move(State<BitBoard>& t_state, const StateUndo<BitBoard>& t_undo) {
+        if (t_undo.selectedCount + 1 == t_state.playerCount) {
+            t_state.board.unmake_move(t_undo.board);
         }
-        t_nodes[t_state].visitCount++;
+
+        t_state.selectedMoves = t_undo.selectedMoves;
+        t_state.selectedCount = t_undo.selectedCount;
     }
 
-    std::vector<Simulator::Direction> suct_get_unselected_moves(const State& t_state, const NodeMap& t_nodes) {
-        std::vector<Simulator::Direction> possibleMoves = 
-            get_safe_moves(t_state.board, t_state.turnOrder[t_state.selectedMoves.size()]);
-        
-        auto eraseIt = std::remove_if(
-            possibleMoves.begin(),
-            possibleMoves.end(),
-            [&t_state, &t_nodes](Simulator::Direction move) -> bool {
-                const State nextState = suct_update_state(t_state, move);
-                return t_nodes.count(nextState);
+    template <class BitBoard>
+    void suct_play_move(State<BitBoard>& t_state, Simulator::Direction t_move) {
+        t_state.selectedMoves[t_state.selectedCount++] = t_move;
+
+        if (t_state.selectedCount == t_state.playerCount) {
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < t_state.playerCount; i++) {
+                moves[t_state.turnOrder[i]] = t_state.selectedMoves[i];
             }
-        );
-        possibleMoves.erase(eraseIt, possibleMoves.end());
 
-        return possibleMoves;
+            t_state.board.update(moves);
+            t_state.selectedMoves = {};
+            t_state.selectedCount = 0;
+        }
     }
 
-    RewardMap suct_evaluate_state(const State& t_state) {
-        RewardMap result;
-        for (const std::string& id : t_state.turnOrder) {
-            result[id] = 0.0f;
+    void suct_update_node(Node& t_node, const RewardArray& t_rewards) {
+        for (unsigned int i = 0; i < t_rewards.size(); i++) {
+            t_node.rewards[i] += t_rewards[i];
         }
-        
-        const std::string* winner = t_state.board.get_winner();
-        if (winner != nullptr) {
-            result[*winner] = 1.0f;
+        t_node.visitCount++;
+    }
+
+    void suct_solve_node(NodeArena& t_nodes, NodeIndex t_node, const std::vector<Simulator::Direction>& t_safeMoves, unsigned int t_player, unsigned int t_firstPlayer) {
+        // Without a safe move the player is stepped UP, as in suct_select_move
+        const std::vector<Simulator::Direction> moves = t_safeMoves.empty() ? std::vector<Simulator::Direction>{Simulator::Direction::UP} : t_safeMoves;
+
+        // Outcomes ranked for the first player, which every other snake winning is as bad as
+        const auto rank = [t_firstPlayer](uint8_t t_outcome) {
+            return (t_outcome == t_firstPlayer) ? 2 : (t_outcome == OUTCOME_DRAW) ? 1 : 0;
+        };
+        const bool firstOfTurn = (t_player == t_firstPlayer);
+
+        uint8_t chosen = OUTCOME_UNSOLVED;
+        bool allSolved = true;
+        for (const Simulator::Direction move : moves) {
+            const NodeIndex child = t_nodes[t_node].children[static_cast<unsigned int>(move)];
+            const uint8_t outcome = (child != NodeArena::NONE) ? t_nodes[child].outcome : OUTCOME_UNSOLVED;
+
+            if (firstOfTurn && outcome == t_player) {
+                t_nodes[t_node].outcome = outcome;
+                return;
+            }
+
+            if (outcome == OUTCOME_UNSOLVED) {
+                allSolved = false;
+                continue;
+            }
+
+            // Among outcomes the first player loses, a later player picks the one it wins
+            if (chosen == OUTCOME_UNSOLVED
+                || (firstOfTurn && rank(outcome) > rank(chosen))
+                || (!firstOfTurn && (rank(outcome) < rank(chosen) || (rank(outcome) == rank(chosen) && outcome == t_player)))) {
+                chosen = outcome;
+            }
         }
 
+        if (allSolved) {
+            t_nodes[t_node].outcome = chosen;
+        }
+    }
+
+    RewardArray suct_outcome_rewards(uint8_t t_outcome) {
+        // Same rewards as suct_evaluate_state
+        RewardArray result{};
+        if (t_outcome < Simulator::MAX_SNAKES) {
+            result[t_outcome] = 1.0f;
+        }
         return result;
     }
 
-    RewardMap suct_mcts_rollout(const State& t_state) {
-        static constexpr std::array<Simulator::Direction (*)(const Simulator::Board&, const std::string&), 2> STRATEGIES {
+    std::vector<Simulator::Direction> suct_get_unselected_moves(const std::vector<Simulator::Direction>& t_safeMoves, const Node& t_node) {
+        std::vector<Simulator::Direction> possibleMoves;
+        for (const Simulator::Direction move : t_safeMoves) {
+            if (t_node.children[static_cast<unsigned int>(move)] == NodeArena::NONE) {
+                possibleMoves.push_back(move);
+            }
+        }
+
+        return possibleMoves;
+    }
+
+    template <class BitBoard>
+    RewardArray suct_evaluate_state(const State<BitBoard>& t_state) {
+        RewardArray result{};
+
+        const unsigned int winner = t_state.board.get_winner();
+        if (winner < t_state.board.get_snake_count()) {
+            result[winner] = 1.0f;
+        }
+
+        return result;
+    }
+
+    template <class BitBoard>
+    RewardArray suct_mcts_rollout(const State<BitBoard>& t_state, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        static constexpr std::array<Simulator::Direction (*)(const BitBoard&, unsigned int, Simulator::Rng&), 2> STRATEGIES {
             avoid_walls_player,
             seek_food_player
         };
 
-        State currentState = t_state;
+        // Rollouts never probe the table, so they leave the symmetric hashes out of their moves
+        State<BitBoard> currentState = t_state;
+        currentState.board.track_symmetric_hashes(false);
+        unsigned int turns = 0;
         while(!currentState.board.is_game_over()) {
-            const std::string& currentPlayerId = currentState.turnOrder[currentState.selectedMoves.size()];
-            const auto strategy = STRATEGIES[rng() % STRATEGIES.size()];
-            const Simulator::Direction move = strategy(t_state.board, currentPlayerId);
-            currentState = suct_update_state(currentState, move);
+            if (turns == t_params.rolloutDepth && t_params.rolloutDepth != 0) {
+                return heuristic_evaluate(currentState.board, t_params.weights);
+            }
+
+            const unsigned int currentPlayerIndex = currentState.get_current_player();
+            const auto strategy = STRATEGIES[t_rng.below(STRATEGIES.size())];
+            const Simulator::Direction move = strategy(currentState.board, currentPlayerIndex, t_rng);
+            suct_play_move(currentState, move);
+
+            if (currentState.selectedCount == 0) {
+                turns++;
+            }
         }
         return suct_evaluate_state(currentState);
     }
@@ -226,61 +1080,121 @@ namespace AI {
         return (t_reward / t_n) + t_c * std::sqrt(std::log(t_N) / t_n);
     }
 
-    Simulator::Direction suct_select_move(const State& t_state, const NodeMap& t_nodes, MCTSParameters t_params) {
-        const std::string& currentPlayerId = t_state.turnOrder[t_state.selectedMoves.size()];
-
-        const std::vector<Simulator::Direction> safeMoves = get_safe_moves(t_state.board, currentPlayerId);
-        if (safeMoves.empty()) {
+    Simulator::Direction suct_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const NodeArena& t_nodes, NodeIndex t_node, unsigned int t_playerIndex, MCTSParameters t_params) {
+        if (t_safeMoves.empty()) {
             return Simulator::Direction::UP;
         }
-        
-        Simulator::Direction bestMove = safeMoves[0];
-        float bestMoveUCB = -std::numeric_limits<float>::infinity();
-        for (const Simulator::Direction move : safeMoves) {
-            const State nextState = suct_update_state(t_state, move);
 
-            auto nodeIt = t_nodes.find(nextState);
+        const Node& parent = t_nodes[t_node];
+
+        // Solved children are only chosen once every child is solved, sampling them again tells nothing
+        const bool skipSolved = std::any_of(t_safeMoves.begin(), t_safeMoves.end(), [&](Simulator::Direction t_move) {
+            const NodeIndex child = parent.children[static_cast<unsigned int>(t_move)];
+            return child == NodeArena::NONE || t_nodes[child].outcome == OUTCOME_UNSOLVED;
+        });
+
+        Simulator::Direction bestMove = t_safeMoves[0];
+        float bestMoveUCB = -std::numeric_limits<float>::infinity();
+        for (const Simulator::Direction move : t_safeMoves) {
+            const NodeIndex child = parent.children[static_cast<unsigned int>(move)];
 
             // If we haven't visited this node then UCB value will be +inf
-            if (nodeIt == t_nodes.end()) {
+            if (child == NodeArena::NONE) {
                 bestMove = move;
                 break;
             }
-            
-            const RewardMap& rewards = nodeIt->second.rewards;
-            const auto rewardIt = rewards.find(currentPlayerId);
-            const auto parentNodeIt = t_nodes.find(t_state);
-            if (rewardIt != rewards.end() && parentNodeIt != t_nodes.end()) {
-                const float r = rewardIt->second;
-                const unsigned int n = nodeIt->second.visitCount;
-                const unsigned int N = parentNodeIt->second.visitCount;
-
-                const float ucb = suct_ucb(r, n, N, t_params.ucbConstant);
-                if (ucb > bestMoveUCB) {
-                    bestMove = move;
-                    bestMoveUCB = ucb;
-                }
+            if (skipSolved && t_nodes[child].outcome != OUTCOME_UNSOLVED) continue;
+
+            const float r = t_nodes[child].rewards[t_playerIndex];
+            const unsigned int n = t_nodes[child].visitCount;
+            const unsigned int N = parent.visitCount;
+
+            const float ucb = suct_ucb(r, n, N, t_params.ucbConstant);
+            if (ucb > bestMoveUCB) {
+                bestMove = move;
+                bestMoveUCB = ucb;
+            }
+        }
+
+        return bestMove;
+    }
+
+    Simulator::Direction suct_tree_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const SharedArena& t_nodes, NodeIndex t_node, unsigned int t_playerIndex, MCTSParameters t_params) {
+        if (t_safeMoves.empty()) {
+            return Simulator::Direction::UP;
+        }
+
+        const SharedNode& parent = t_nodes[t_node];
+        const unsigned int N = parent.visitCount.load(std::memory_order_relaxed);
+
+        Simulator::Direction bestMove = t_safeMoves[0];
+        float bestMoveUCB = -std::numeric_limits<float>::infinity();
+        for (const Simulator::Direction move : t_safeMoves) {
+            const NodeIndex child = parent.children[static_cast<unsigned int>(move)].load(std::memory_order_acquire);
+            if (child == SharedArena::NONE) {
+                bestMove = move;
+                break;
+            }
+
+            const float r = t_nodes[child].rewards[t_playerIndex].load(std::memory_order_relaxed);
+            const unsigned int n = t_nodes[child].visitCount.load(std::memory_order_relaxed);
+
+            const float ucb = suct_ucb(r, n, N, t_params.ucbConstant);
+            if (ucb > bestMoveUCB) {
+                bestMove = move;
+                bestMoveUCB = ucb;
             }
         }
 
         return bestMove;
     }
 
-    bool operator==(const State& t_s1, const State& t_s2) {
-        return
-            (t_s1.turnOrder == t_s2.turnOrder) &&
-            (t_s1.selectedMoves == t_s2.selectedMoves) &&
-            (t_s1.board == t_s2.board);
+    Simulator::Direction suct_table_select_move(const std::vector<Simulator::Direction>& t_safeMoves, const SuctEntry& t_entry, MCTSParameters t_params, Simulator::Rng& t_rng) {
+        if (t_safeMoves.empty()) {
+            return Simulator::Direction::UP;
+        }
+
+        // Untried moves are tried first in a random order
+        std::array<Simulator::Direction, 4> untried{};
+        unsigned int untriedCount = 0;
+        for (const Simulator::Direction move : t_safeMoves) {
+            if (t_entry.visits[static_cast<unsigned int>(move)] == 0) {
+                untried[untriedCount++] = move;
+            }
+        }
+        if (untriedCount != 0) {
+            return untried[t_rng.below(untriedCount)];
+        }
+
+        Simulator::Direction bestMove = t_safeMoves[0];
+        float bestMoveUCB = -std::numeric_limits<float>::infinity();
+        for (const Simulator::Direction move : t_safeMoves) {
+            const unsigned int i = static_cast<unsigned int>(move);
+            const float ucb = suct_ucb(t_entry.rewards[i], t_entry.visits[i], t_entry.visitCount, t_params.ucbConstant);
+            if (ucb > bestMoveUCB) {
+                bestMove = move;
+                bestMoveUCB = ucb;
+            }
+        }
+
+        return bestMove;
     }
 
-    size_t StateHash::operator()(const State& t_state) const noexcept {
-        size_t result = Simulator::BoardHash{}(t_state.board);
+    void suct_tree_update_node(SharedNode& t_node, const RewardArray& t_rewards) {
+        // There is no atomic add for floats before C++20
+        for (unsigned int i = 0; i < t_rewards.size(); i++) {
+            if (t_rewards[i] == 0.0f) continue;
 
-        for (Simulator::Direction move : t_state.selectedMoves) {
-            result = (result ^ (static_cast<size_t>(move) << 1)) >> 1;
+            float expected = t_node.rewards[i].load(std::memory_order_relaxed);
+            while (!t_node.rewards[i].compare_exchange_weak(expected, expected + t_rewards[i], std::memory_order_relaxed)) {
+                ;
+            }
         }
+    }
 
-        return result;
+    template <class BitBoard>
+    unsigned int State<BitBoard>::get_current_player() const {
+        return turnOrder[selectedCount];
     }
 
 }
@@ -0,0 +1,112 @@
+#ifndef ARENA_INCLUDED
+#define ARENA_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace AI {
+
+    // Pool of search tree nodes addressed by index. Indices stay valid while
+    // the pool grows, unlike references, and reset frees every node at once
+    // while keeping the memory for the next search.
+    template <typename T>
+    class Arena {
+    public:
+        using Index = uint32_t;
+
+        // Index of no node, used for missing links
+        static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+        explicit Arena(size_t t_capacity=0) {
+            m_items.reserve(t_capacity);
+        }
+
+        // Returns the index of a new value initialised T
+        Index allocate() {
+            m_items.emplace_back();
+            return static_cast<Index>(m_items.size() - 1);
+        }
+
+        T& operator[](Index t_index) {
+            return m_items[t_index];
+        }
+
+        [[nodiscard]] const T& operator[](Index t_index) const {
+            return m_items[t_index];
+        }
+
+        [[nodiscard]] size_t size() const {
+            return m_items.size();
+        }
+
+        void reset() {
+            m_items.clear();
+        }
+    private:
+        std::vector<T> m_items;
+    };
+
+    // Pool of a fixed number of nodes that threads can allocate from at the
+    // same time. Nodes are constructed up front and never move, so a thread
+    // can read a node while others allocate.
+    template <typename T>
+    class ConcurrentArena {
+    public:
+        using Index = uint32_t;
+
+        static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+        explicit ConcurrentArena(Index t_capacity)
+            : m_items(new T[t_capacity])
+            , m_capacity(t_capacity)
+            , m_size(0)
+        {
+            ;
+        }
+
+        // Returns the index of an unused node, or NONE once every node is in use
+        Index allocate() {
+            // Checked first so that failed allocations cannot wrap the count around
+            if (m_size.load(std::memory_order_relaxed) >= m_capacity) {
+                return NONE;
+            }
+
+            const Index index = m_size.fetch_add(1, std::memory_order_relaxed);
+            return (index < m_capacity) ? index : NONE;
+        }
+
+        T& operator[](Index t_index) {
+            return m_items[t_index];
+        }
+
+        [[nodiscard]] const T& operator[](Index t_index) const {
+            return m_items[t_index];
+        }
+
+        [[nodiscard]] size_t size() const {
+            return std::min(m_size.load(std::memory_order_relaxed), m_capacity);
+        }
+
+        // Frees every node, only the nodes that were in use are constructed
+        // again. No other thread may use the arena meanwhile.
+        void reset() {
+            for (size_t i = 0; i < size(); i++) {
+                m_items[i].~T();
+                new (&m_items[i]) T();
+            }
+            m_size.store(0, std::memory_order_relaxed);
+        }
+    private:
+        std::unique_ptr<T[]> m_items;
+        Index m_capacity;
+        std::atomic<Index> m_size;
+    };
+
+}
+
+#endif
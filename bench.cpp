@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ai.hpp"
+#include "simulator.hpp"
+
+// Searches per measurement, each from the opening position of ai_run
+constexpr unsigned int SEARCH_COUNT = 5;
+constexpr unsigned int COMPUTE_TIME = 200;
+
+struct Measurement {
+    double iterationsPerSecond;
+    uint64_t nodes; // Average per search
+    double tableOccupancy; // Averages per search, zero without a transposition table
+    uint64_t tableCollisions;
+    double tableHitsPerIteration; // Decisions found in the table by an iteration before it adds one
+};
+
+using Player = Simulator::Direction (*)(const Simulator::Board&, unsigned int, AI::MCTSParameters, AI::SearchStats*);
+
+Measurement measure(Player t_player, const Simulator::Board& t_board, unsigned int t_threads, unsigned int t_rolloutDepth=0, unsigned int t_tableMegabytes=0, bool t_symmetry=false) {
+    AI::MCTSParameters params{COMPUTE_TIME, 1.0f, 0, t_threads, t_rolloutDepth};
+    params.tableMegabytes = t_tableMegabytes;
+    params.symmetry = t_symmetry;
+
+    uint64_t iterations = 0;
+    uint64_t nodes = 0;
+    double occupancy = 0.0;
+    uint64_t collisions = 0;
+    uint64_t hits = 0;
+    for (unsigned int i = 0; i < SEARCH_COUNT; i++) {
+        AI::SearchStats stats{};
+        params.seed = i;
+        t_player(t_board, 0, params, &stats);
+        iterations += stats.iterations;
+        nodes += stats.nodes;
+        occupancy += stats.table.get_occupancy();
+        collisions += stats.table.collisions;
+        hits += stats.table.hits;
+    }
+
+    return Measurement{iterations * 1000.0 / (SEARCH_COUNT * COMPUTE_TIME), nodes / SEARCH_COUNT, occupancy / SEARCH_COUNT, collisions / SEARCH_COUNT, static_cast<double>(hits) / std::max<uint64_t>(iterations, 1)};
+}
+
+// Plays rollouts from t_board to the end for COMPUTE_TIME and returns the moves made per second
+template <class Geometry>
+double measure_rollouts(const Simulator::Board& t_board) {
+    using std::chrono::duration_cast;
+    using std::chrono::high_resolution_clock;
+    using std::chrono::milliseconds;
+
+    const Simulator::BasicBitBoard<Geometry> start(t_board);
+    Simulator::Rng rng(0);
+
+    uint64_t plies = 0;
+    const auto t1 = high_resolution_clock::now();
+    while (duration_cast<milliseconds>(high_resolution_clock::now() - t1).count() < COMPUTE_TIME) {
+        Simulator::BasicBitBoard<Geometry> board = start;
+        while (!board.is_game_over()) {
+            plies += AI::rollout_turn(board, rng);
+        }
+    }
+
+    return plies * 1000.0 / COMPUTE_TIME;
+}
+
+// Works out the territory of t_board for COMPUTE_TIME and returns the nanoseconds per call
+template <class Geometry>
+double measure_territory(const Simulator::Board& t_board) {
+    using std::chrono::duration_cast;
+    using std::chrono::high_resolution_clock;
+    using std::chrono::milliseconds;
+
+    const Simulator::BasicBitBoard<Geometry> board(t_board);
+
+    // Summed so that the calls cannot be optimised away
+    uint64_t calls = 0;
+    uint64_t owned = 0;
+    const auto t1 = high_resolution_clock::now();
+    while (duration_cast<milliseconds>(high_resolution_clock::now() - t1).count() < COMPUTE_TIME) {
+        for (unsigned int i = 0; i < 1000; i++) {
+            owned += board.get_territory().owned[0];
+        }
+        calls += 1000;
+    }
+
+    return (owned != 0) ? COMPUTE_TIME * 1e6 / calls : 0.0;
+}
+
+// Prints the search speed of root and tree parallel SUCT, given the same time,
+// for 1 up to N threads. N is the first argument or the number of hardware threads.
+// Then prints the speed of single threaded SUCT for a range of rollout depths,
+// the speed and table use of single threaded SUCT with transposition tables
+// of a range of sizes, with and without sharing entries between symmetric
+// positions, the speed of the rollout kernel alone and the time
+// taken to work out the territory of every snake.
+int main(int argc, char* argv[]) {
+    const unsigned int maxThreads = (argc > 1) ? std::stoul(argv[1]) : std::max(std::thread::hardware_concurrency(), 1u);
+
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake(Simulator::Position{1, 1}, 3, 100),
+        Simulator::Snake(Simulator::Position{1, 9}, 3, 100),
+        Simulator::Snake(Simulator::Position{9, 1}, 3, 100),
+        Simulator::Snake(Simulator::Position{9, 9}, 3, 100),
+    };
+    const Simulator::FoodGrid food = {Grid<bool>(11, 11), 0};
+    const Simulator::Board board{snakes, food};
+
+    // Thread counts double up to the maximum, which is always measured
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "threads  suct it/s  speedup  tree_suct it/s  speedup  tree_suct nodes\n";
+
+    double rootBaseline = 0.0;
+    double treeBaseline = 0.0;
+    for (const unsigned int threads : threadCounts) {
+        const Measurement root = measure(AI::mcts_suct_player, board, threads);
+        const Measurement tree = measure(AI::mcts_tree_suct_player, board, threads);
+        if (rootBaseline == 0.0) {
+            rootBaseline = root.iterationsPerSecond;
+            treeBaseline = tree.iterationsPerSecond;
+        }
+
+        std::cout << std::setw(7) << threads << "  "
+                  << std::setw(9) << static_cast<uint64_t>(root.iterationsPerSecond) << "  "
+                  << std::fixed << std::setprecision(2) << std::setw(7) << root.iterationsPerSecond / rootBaseline << "  "
+                  << std::setw(14) << static_cast<uint64_t>(tree.iterationsPerSecond) << "  "
+                  << std::setw(7) << tree.iterationsPerSecond / treeBaseline << "  "
+                  << std::setw(15) << tree.nodes << '\n';
+    }
+
+    // Rollouts cut off early are scored by the heuristic, 0 plays them to the end
+    std::cout << "\nrollout depth  suct it/s\n";
+    for (const unsigned int depth : {0u, 40u, 20u, 10u, 5u}) {
+        const Measurement root = measure(AI::mcts_suct_player, board, 1, depth);
+        std::cout << std::setw(13) << depth << "  " << std::setw(9) << static_cast<uint64_t>(root.iterationsPerSecond) << '\n';
+    }
+
+    // Searches with a table use the same memory however long they run, 0 is the tree
+    std::cout << "\ntable MB  suct it/s  entries  occupancy  collisions\n";
+    for (const unsigned int megabytes : {0u, 1u, 4u, 16u}) {
+        const Measurement root = measure(AI::mcts_suct_player, board, 1, 0, megabytes);
+        std::cout << std::setw(8) << megabytes << "  "
+                  << std::setw(9) << static_cast<uint64_t>(root.iterationsPerSecond) << "  "
+                  << std::setw(7) << root.nodes << "  "
+                  << std::setw(9) << root.tableOccupancy << "  "
+                  << std::setw(10) << root.tableCollisions << '\n';
+    }
+
+    // Snakes keep their indices under a symmetry, so the images of a duel
+    // from opposite corners are the same position and share their entries.
+    // Sharing shows as iterations going deeper through the table.
+    const Simulator::Board duel{{snakes[0], snakes[3]}, food};
+    std::cout << "\nsymmetry  suct it/s  hits per iteration\n";
+    for (const bool symmetry : {false, true}) {
+        const Measurement root = measure(AI::mcts_suct_player, duel, 1, 0, 16, symmetry);
+        std::cout << std::setw(8) << (symmetry ? "on" : "off") << "  "
+                  << std::setw(9) << static_cast<uint64_t>(root.iterationsPerSecond) << "  "
+                  << std::setw(18) << root.tableHitsPerIteration << '\n';
+    }
+
+    // A ply is the move of one snake
+    std::cout << "\nrollout plies/s\n";
+    std::cout << std::setw(15) << static_cast<uint64_t>(measure_rollouts<Simulator::FixedGeometry<11, 11>>(board)) << '\n';
+
+    std::cout << "\nterritory ns\n";
+    std::cout << std::setw(12) << measure_territory<Simulator::FixedGeometry<11, 11>>(board) << '\n';
+
+    return 0;
+}
@@ -0,0 +1,798 @@
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+#include "bitboard.hpp"
+#include "zobrist.hpp"
+
+namespace Simulator {
+
+    template <class Geometry>
+    BasicBitBoard<Geometry>::BasicBitBoard(const Board& t_board, uint64_t t_seed)
+        : m_ruleset(t_board.get_ruleset())
+        , m_geometry(m_ruleset.w, m_ruleset.h)
+        , m_occupied{}
+        , m_links{}
+        , m_food{}
+        , m_snakes{}
+        , m_hash(0)
+        , m_symmetricHashes{}
+        , m_rng(t_seed)
+        , m_foodCount(t_board.get_food().count)
+        , m_snakeCount(t_board.get_snake_count())
+        , m_alive(0)
+        , m_symmetryCount(0)
+    {
+        const Grid<bool>& food = t_board.get_food().cells;
+        const uint64_t columns = (m_ruleset.w >= 64) ? ~uint64_t{0} : (uint64_t{1} << m_ruleset.w) - 1;
+        for (unsigned int y = 0; y < std::min(food.get_height(), m_ruleset.h); y++) {
+            for (uint64_t row = food.get_row(y) & columns; row != 0; row &= row - 1) {
+                m_food.set(y * m_ruleset.w + __builtin_ctzll(row));
+            }
+        }
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!t_board.is_alive(i)) {
+                continue;
+            }
+
+            const Snake& snake = t_board.get_snake(i);
+
+            SnakeState& state = m_snakes[i];
+            state.tail = m_geometry.to_cell(snake.get_tail());
+            state.head = m_geometry.to_cell(snake.get_head());
+            state.length = snake.get_length();
+            state.stacked = 0;
+            state.health = snake.get_health();
+
+            m_occupied.set(state.tail);
+            for (unsigned int j = 1; j < state.length; j++) {
+                const Position previous = snake.get_segment(j - 1);
+                const Position segment = snake.get_segment(j);
+                if (segment == previous) {
+                    state.stacked++;
+                    continue;
+                }
+
+                set_link(m_geometry.to_cell(previous), direction_to(previous, segment));
+                m_occupied.set(m_geometry.to_cell(segment));
+            }
+
+            m_alive |= (1u << i);
+        }
+
+        m_hash = compute_hash();
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::update(const MoveArray& t_moves) {
+        make_move(t_moves);
+    }
+
+    template <class Geometry>
+    typename BasicBitBoard<Geometry>::Undo BasicBitBoard<Geometry>::make_move(const MoveArray& t_moves) {
+        Undo undo{m_snakes, {}, m_food, m_hash, m_symmetricHashes, m_rng, m_foodCount, m_alive};
+
+        // New head cells, OFF_BOARD for snakes leaving the board
+        std::array<unsigned int, MAX_SNAKES> heads{};
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            SnakeState& snake = m_snakes[i];
+            heads[i] = m_geometry.neighbour(snake.head, t_moves[i]);
+            undo.headLinks[i] = get_link(snake.head);
+            set_link(snake.head, t_moves[i]);
+
+            // The new head is only hashed once it is known to survive
+            hash_head(snake.head, i);
+            hash_link(snake.head, i, t_moves[i]);
+            hash_key(
+                Zobrist::length(i, snake.length) ^ Zobrist::length(i, snake.length + 1) ^
+                Zobrist::health(i, snake.health) ^ Zobrist::health(i, snake.health - 1)
+            );
+            snake.length++;
+            snake.health--;
+        }
+
+        // Feed snakes, food is only removed once every snake has been checked
+        // so that snakes meeting head on over food both eat
+        uint8_t fed = 0;
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            if (heads[i] != OFF_BOARD && m_food.test(heads[i])) {
+                hash_key(Zobrist::health(i, m_snakes[i].health) ^ Zobrist::health(i, m_ruleset.startingHealth));
+                m_snakes[i].health = m_ruleset.startingHealth;
+                fed |= (1u << i);
+            }
+            else {
+                pop_tail(i);
+            }
+        }
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if ((fed >> i) & 1) {
+                if (m_food.test(heads[i])) {
+                    m_food.reset(heads[i]);
+                    m_foodCount--;
+                    hash_food(heads[i]);
+                }
+            }
+        }
+
+        // The new heads are not part of m_occupied yet, so it currently holds
+        // exactly the segments a head is not allowed to move onto
+        uint8_t eliminated = 0;
+        CellSet blocked = m_occupied;
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            const SnakeState& snake = m_snakes[i];
+            bool safe = snake.health > 0 && heads[i] != OFF_BOARD && !m_occupied.test(heads[i]);
+
+            for (unsigned int j = 0; j < m_snakeCount && safe; j++) {
+                if (j != i && is_alive(j) && heads[j] == heads[i] && snake.length <= m_snakes[j].length) {
+                    safe = false;
+                }
+            }
+
+            if (!safe) {
+                eliminated |= (1u << i);
+            }
+            if (heads[i] != OFF_BOARD) {
+                blocked.set(heads[i]);
+            }
+        }
+
+        spawn_food(blocked);
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            if ((eliminated >> i) & 1) {
+                remove_snake(i);
+            }
+            else {
+                m_snakes[i].head = heads[i];
+                m_occupied.set(m_snakes[i].head);
+                hash_head(m_snakes[i].head, i);
+            }
+        }
+
+        return undo;
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::unmake_move(const Undo& t_undo) {
+        // New heads go first as one may sit on a tail that has to be restored
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (is_alive(i)) {
+                m_occupied.reset(m_snakes[i].head);
+            }
+        }
+
+        m_snakes = t_undo.snakes;
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!((t_undo.alive >> i) & 1)) continue;
+
+            // Links are never cleared, so the whole body of an eliminated snake can be walked again
+            const SnakeState& snake = m_snakes[i];
+            if (is_alive(i)) {
+                m_occupied.set(snake.tail);
+            }
+            else {
+                unsigned int cell = snake.tail;
+                for (unsigned int j = snake.stacked + 1; j < snake.length; j++) {
+                    m_occupied.set(cell);
+                    cell = m_geometry.neighbour(cell, get_link(cell));
+                }
+                m_occupied.set(snake.head);
+            }
+            set_link(snake.head, t_undo.headLinks[i]);
+        }
+
+        m_food = t_undo.food;
+        m_hash = t_undo.hash;
+        m_symmetricHashes = t_undo.symmetricHashes;
+        m_rng = t_undo.rng;
+        m_foodCount = t_undo.foodCount;
+        m_alive = t_undo.alive;
+    }
+
+    template <class Geometry>
+    Ruleset BasicBitBoard<Geometry>::get_ruleset() const {
+        return m_ruleset;
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::is_in_bounds(Position t_position) const {
+        return m_geometry.is_in_bounds(t_position);
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::is_safe_cell(unsigned int t_index, Position t_position) const {
+        if (!is_in_bounds(t_position) || !is_alive(t_index)) {
+            return false;
+        }
+
+        return is_safe_cell(t_index, m_geometry.to_cell(t_position));
+    }
+
+    template <class Geometry>
+    unsigned int BasicBitBoard<Geometry>::get_safe_move_mask(unsigned int t_index) const {
+        if (!is_alive(t_index)) {
+            return 0;
+        }
+
+        const unsigned int head = m_snakes[t_index].head;
+        unsigned int result = 0;
+        for (unsigned int i = 0; i < 4; i++) {
+            const unsigned int cell = m_geometry.neighbour(head, static_cast<Direction>(i));
+            if (cell != OFF_BOARD && is_safe_cell(t_index, cell)) {
+                result |= (1u << i);
+            }
+        }
+
+        return result;
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::is_safe_cell(unsigned int t_index, unsigned int t_cell) const {
+        if (!m_occupied.test(t_cell)) {
+            return true;
+        }
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i) || m_snakes[i].head != t_cell) continue;
+
+            const SnakeState& snake = m_snakes[i];
+
+            // Every segment is stacked on the head, so the cell is body as well
+            if (snake.tail == snake.head && snake.length > 1) {
+                return false;
+            }
+
+            return i == t_index || m_snakes[t_index].length > snake.length;
+        }
+
+        return false;
+    }
+
+    template <class Geometry>
+    unsigned int BasicBitBoard<Geometry>::get_snake_count() const {
+        return m_snakeCount;
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::is_alive(unsigned int t_index) const {
+        return (m_alive >> t_index) & 1;
+    }
+
+    template <class Geometry>
+    Position BasicBitBoard<Geometry>::get_head(unsigned int t_index) const {
+        return m_geometry.to_position(m_snakes[t_index].head);
+    }
+
+    template <class Geometry>
+    unsigned int BasicBitBoard<Geometry>::get_length(unsigned int t_index) const {
+        return m_snakes[t_index].length;
+    }
+
+    template <class Geometry>
+    int BasicBitBoard<Geometry>::get_health(unsigned int t_index) const {
+        return m_snakes[t_index].health;
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::has_food(Position t_position) const {
+        return is_in_bounds(t_position) && m_food.test(m_geometry.to_cell(t_position));
+    }
+
+    template <class Geometry>
+    unsigned int BasicBitBoard<Geometry>::get_food_count() const {
+        return m_foodCount;
+    }
+
+    template <class Geometry>
+    std::optional<Position> BasicBitBoard<Geometry>::get_closest_food(Position t_position) const {
+        // Food is visited in cell order, so ties go to the first food in row major order
+        std::optional<Position> result;
+        unsigned int closestDistance = std::numeric_limits<unsigned int>::max();
+        for (unsigned int i = 0; i < CellSet::WORD_COUNT; i++) {
+            for (uint64_t word = m_food.words[i]; word != 0; word &= word - 1) {
+                const Position food = m_geometry.to_position(i * 64 + __builtin_ctzll(word));
+                const unsigned int distance = std::abs(food.x - t_position.x) + std::abs(food.y - t_position.y);
+                if (distance < closestDistance) {
+                    result = food;
+                    closestDistance = distance;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template <class Geometry>
+    Territory BasicBitBoard<Geometry>::get_territory() const {
+        // Fixed geometries all have the same dimensions, so their masks are only worked out once
+        ShiftMasks dynamicMasks{};
+        const ShiftMasks* masks = &dynamicMasks;
+        if constexpr (std::is_same_v<Geometry, DynamicGeometry>) {
+            dynamicMasks = make_shift_masks(m_geometry);
+        }
+        else {
+            static const ShiftMasks FIXED_MASKS = make_shift_masks(m_geometry);
+            masks = &FIXED_MASKS;
+        }
+
+        CellSet walls = m_occupied;
+        CellSet claimed{};
+        std::array<CellSet, MAX_SNAKES> owned{};
+        std::array<CellSet, MAX_SNAKES> reachable{};
+        // Cells first entered on the previous turn, the only ones to grow from
+        std::array<CellSet, MAX_SNAKES> ownedFront{};
+        std::array<CellSet, MAX_SNAKES> reachableFront{};
+
+        // Bodies are walked from the tail, freeing one cell a turn once the segments stacked on the tail have left
+        std::array<uint16_t, MAX_SNAKES> nextFreed{};
+        std::array<uint16_t, MAX_SNAKES> walled{};
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            const SnakeState& snake = m_snakes[i];
+            owned[i].set(snake.head);
+            reachable[i].set(snake.head);
+            ownedFront[i] = owned[i];
+            reachableFront[i] = reachable[i];
+            claimed.set(snake.head);
+            nextFreed[i] = snake.tail;
+            walled[i] = snake.length - snake.stacked;
+        }
+
+        for (unsigned int turn = 1; ; turn++) {
+            for (unsigned int i = 0; i < m_snakeCount; i++) {
+                if (!is_alive(i) || walled[i] == 0 || turn <= m_snakes[i].stacked) continue;
+
+                walls.reset(nextFreed[i]);
+                if (--walled[i] != 0) {
+                    nextFreed[i] = m_geometry.neighbour(nextFreed[i], get_link(nextFreed[i]));
+                }
+            }
+
+            bool growing = false;
+
+            // Cells entered this turn, by any snake and by more than one
+            CellSet reached{};
+            CellSet contested{};
+            for (unsigned int i = 0; i < m_snakeCount; i++) {
+                if (!is_alive(i)) continue;
+
+                CellSet& reachableNext = reachableFront[i];
+                if (reachableNext.any()) {
+                    reachableNext = dilate(reachableNext, *masks);
+                    reachableNext.and_not(walls);
+                    reachableNext.and_not(reachable[i]);
+                    reachable[i] |= reachableNext;
+                    growing |= reachableNext.any();
+                }
+
+                CellSet& ownedNext = ownedFront[i];
+                if (ownedNext.any()) {
+                    ownedNext = dilate(ownedNext, *masks);
+                    ownedNext.and_not(walls);
+                    ownedNext.and_not(claimed);
+
+                    CellSet again = ownedNext;
+                    again &= reached;
+                    contested |= again;
+                    reached |= ownedNext;
+                    growing |= ownedNext.any();
+                }
+            }
+
+            if (!growing) break;
+
+            // Contested cells stay claimed, so no snake grows through them
+            claimed |= reached;
+            for (unsigned int i = 0; i < m_snakeCount; i++) {
+                ownedFront[i].and_not(contested);
+                owned[i] |= ownedFront[i];
+            }
+        }
+
+        Territory result{};
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            result.reachable[i] = static_cast<uint16_t>(reachable[i].count());
+            result.owned[i] = static_cast<uint16_t>(owned[i].count());
+        }
+
+        return result;
+    }
+
+    template <class Geometry>
+    uint64_t BasicBitBoard<Geometry>::get_hash() const {
+        return m_hash;
+    }
+
+    template <class Geometry>
+    std::array<uint64_t, SYMMETRY_COUNT> BasicBitBoard<Geometry>::get_symmetric_hashes() const {
+        if (m_symmetryCount == 0) {
+            return compute_symmetric_hashes();
+        }
+
+        std::array<uint64_t, SYMMETRY_COUNT> result = m_symmetricHashes;
+        result[0] = m_hash;
+        return result;
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::track_symmetric_hashes(bool t_track) {
+        m_symmetricHashes = t_track ? compute_symmetric_hashes() : std::array<uint64_t, SYMMETRY_COUNT>{};
+        m_symmetryCount = t_track ? get_symmetry_count(m_geometry.get_width(), m_geometry.get_height()) : 0;
+    }
+
+    template <class Geometry>
+    std::array<uint64_t, SYMMETRY_COUNT> BasicBitBoard<Geometry>::compute_symmetric_hashes() const {
+        const unsigned int symmetryCount = get_symmetry_count(m_geometry.get_width(), m_geometry.get_height());
+
+        // Same keys as compute_hash, at the images of the cells and of the links
+        std::array<uint64_t, SYMMETRY_COUNT> result{};
+        const auto hash_cells = [&](unsigned int t_cell, const auto& t_key) {
+            for (unsigned int s = 0; s < symmetryCount; s++) {
+                result[s] ^= t_key(s, transform_cell(s, t_cell));
+            }
+        };
+
+        for (unsigned int i = 0; i < CellSet::WORD_COUNT; i++) {
+            for (uint64_t word = m_food.words[i]; word != 0; word &= word - 1) {
+                hash_cells(i * 64 + __builtin_ctzll(word), [](unsigned int, unsigned int t_cell) {
+                    return Zobrist::food(t_cell);
+                });
+            }
+        }
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            const SnakeState& snake = m_snakes[i];
+            const uint64_t counts = Zobrist::length(i, snake.length) ^ Zobrist::health(i, snake.health);
+            for (unsigned int s = 0; s < symmetryCount; s++) {
+                result[s] ^= counts;
+            }
+
+            unsigned int cell = snake.tail;
+            for (unsigned int j = snake.stacked + 1; j < snake.length; j++) {
+                const Direction link = get_link(cell);
+                hash_cells(cell, [&](unsigned int t_symmetry, unsigned int t_cell) {
+                    return Zobrist::segment(t_cell, i, direction_to_role(transform_direction(t_symmetry, link)));
+                });
+                cell = m_geometry.neighbour(cell, link);
+            }
+            hash_cells(snake.head, [&](unsigned int, unsigned int t_cell) {
+                return Zobrist::segment(t_cell, i, SegmentRole::HEAD);
+            });
+        }
+
+        return result;
+    }
+
+    template <class Geometry>
+    unsigned int BasicBitBoard<Geometry>::get_winner() const {
+        if (m_alive != 0 && (m_alive & (m_alive - 1)) == 0) {
+            for (unsigned int i = 0; i < m_snakeCount; i++) {
+                if (is_alive(i)) {
+                    return i;
+                }
+            }
+        }
+        return m_snakeCount;
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::is_game_over() const {
+        return (m_alive & (m_alive - 1)) == 0;
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::is_supported(const Board& t_board) {
+        const Ruleset ruleset = t_board.get_ruleset();
+        return Geometry::supports(ruleset.w, ruleset.h);
+    }
+
+    template <class Geometry>
+    std::string BasicBitBoard<Geometry>::to_string() const {
+        std::string cells(m_ruleset.w * m_ruleset.h, ' ');
+        for (unsigned int cell = 0; cell < cells.size(); cell++) {
+            if (m_food.test(cell)) {
+                cells[cell] = '*';
+            }
+        }
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            const SnakeState& snake = m_snakes[i];
+            unsigned int cell = snake.tail;
+            for (unsigned int j = snake.stacked + 1; j < snake.length; j++) {
+                cells[cell] = static_cast<char>('a' + i);
+                cell = m_geometry.neighbour(cell, get_link(cell));
+            }
+            cells[snake.head] = 'H';
+        }
+
+        std::string result;
+
+        result += "DIM: " + std::to_string(m_ruleset.w) + 'x' + std::to_string(m_ruleset.h) + '\n';
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (is_alive(i)) {
+                result += "Player " + std::to_string(i) + " Health: " + std::to_string(get_health(i)) + '\n';
+            }
+        }
+
+        result += std::string(2 * m_ruleset.w + 3, '#') + '\n';
+        for (unsigned int y = 0; y < m_ruleset.h; y++) {
+            result += "# ";
+            for (unsigned int x = 0; x < m_ruleset.w; x++) {
+                result += cells[y * m_ruleset.w + x];
+                result += " ";
+            }
+            result += "#\n";
+        }
+        result += std::string(2 * m_ruleset.w + 3, '#') + '\n';
+
+        return result;
+    }
+
+    template <class Geometry>
+    typename BasicBitBoard<Geometry>::ShiftMasks BasicBitBoard<Geometry>::make_shift_masks(const Geometry& t_geometry) {
+        ShiftMasks result{};
+        for (unsigned int cell = 0; cell < t_geometry.get_cell_count(); cell++) {
+            const Position position = t_geometry.to_position(cell);
+            result.board.set(cell);
+            if (position.x != 0) {
+                result.notFirstColumn.set(cell);
+            }
+            if (position.x + 1 != static_cast<int>(t_geometry.get_width())) {
+                result.notLastColumn.set(cell);
+            }
+        }
+        return result;
+    }
+
+    template <class Geometry>
+    typename BasicBitBoard<Geometry>::CellSet BasicBitBoard<Geometry>::dilate(const CellSet& t_cells, const ShiftMasks& t_masks) const {
+        const unsigned int width = m_geometry.get_width();
+
+        CellSet up = t_cells;
+        up >>= width;
+
+        CellSet down = t_cells;
+        down <<= width;
+        down &= t_masks.board;
+
+        CellSet left = t_cells;
+        left &= t_masks.notFirstColumn;
+        left >>= 1;
+
+        CellSet right = t_cells;
+        right &= t_masks.notLastColumn;
+        right <<= 1;
+
+        CellSet result = t_cells;
+        result |= up;
+        result |= down;
+        result |= left;
+        result |= right;
+        return result;
+    }
+
+    template <class Geometry>
+    Direction BasicBitBoard<Geometry>::get_link(unsigned int t_cell) const {
+        return static_cast<Direction>(m_links[0].test(t_cell) | (m_links[1].test(t_cell) << 1));
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::set_link(unsigned int t_cell, Direction t_direction) {
+        const unsigned int bits = static_cast<unsigned int>(t_direction);
+        for (unsigned int plane = 0; plane < 2; plane++) {
+            if ((bits >> plane) & 1) {
+                m_links[plane].set(t_cell);
+            }
+            else {
+                m_links[plane].reset(t_cell);
+            }
+        }
+    }
+
+    template <class Geometry>
+    uint64_t BasicBitBoard<Geometry>::compute_hash() const {
+        uint64_t result = 0;
+        for (unsigned int cell = 0; cell < m_geometry.get_cell_count(); cell++) {
+            if (m_food.test(cell)) {
+                result ^= Zobrist::food(cell);
+            }
+        }
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (!is_alive(i)) continue;
+
+            // Stacked segments are implied by the length
+            const SnakeState& snake = m_snakes[i];
+            result ^= Zobrist::length(i, snake.length) ^ Zobrist::health(i, snake.health);
+
+            unsigned int cell = snake.tail;
+            for (unsigned int j = snake.stacked + 1; j < snake.length; j++) {
+                const Direction link = get_link(cell);
+                result ^= Zobrist::segment(cell, i, direction_to_role(link));
+                cell = m_geometry.neighbour(cell, link);
+            }
+            result ^= Zobrist::segment(snake.head, i, SegmentRole::HEAD);
+        }
+
+        return result;
+    }
+
+    template <class Geometry>
+    unsigned int BasicBitBoard<Geometry>::transform_cell(unsigned int t_symmetry, unsigned int t_cell) const {
+        const unsigned int w = m_geometry.get_width();
+        const unsigned int h = m_geometry.get_height();
+        return m_geometry.to_cell(transform_position(t_symmetry, m_geometry.to_position(t_cell), w, h));
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::hash_key(uint64_t t_key) {
+        m_hash ^= t_key;
+        for (unsigned int s = 1; s < m_symmetryCount; s++) {
+            m_symmetricHashes[s] ^= t_key;
+        }
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::hash_food(unsigned int t_cell) {
+        m_hash ^= Zobrist::food(t_cell);
+        for (unsigned int s = 1; s < m_symmetryCount; s++) {
+            m_symmetricHashes[s] ^= Zobrist::food(transform_cell(s, t_cell));
+        }
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::hash_head(unsigned int t_cell, unsigned int t_index) {
+        m_hash ^= Zobrist::segment(t_cell, t_index, SegmentRole::HEAD);
+        for (unsigned int s = 1; s < m_symmetryCount; s++) {
+            m_symmetricHashes[s] ^= Zobrist::segment(transform_cell(s, t_cell), t_index, SegmentRole::HEAD);
+        }
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::hash_link(unsigned int t_cell, unsigned int t_index, Direction t_link) {
+        m_hash ^= Zobrist::segment(t_cell, t_index, direction_to_role(t_link));
+        for (unsigned int s = 1; s < m_symmetryCount; s++) {
+            m_symmetricHashes[s] ^= Zobrist::segment(transform_cell(s, t_cell), t_index, direction_to_role(transform_direction(s, t_link)));
+        }
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::pop_tail(unsigned int t_index) {
+        SnakeState& snake = m_snakes[t_index];
+        if (snake.stacked > 0) {
+            snake.stacked--;
+        }
+        else {
+            const unsigned int tail = snake.tail;
+            const Direction link = get_link(tail);
+            snake.tail = m_geometry.neighbour(tail, link);
+            m_occupied.reset(tail);
+            hash_link(tail, t_index, link);
+        }
+        hash_key(Zobrist::length(t_index, snake.length) ^ Zobrist::length(t_index, snake.length - 1));
+        snake.length--;
+    }
+
+    // Must be called after the snake has moved but before its new head has been placed
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::remove_snake(unsigned int t_index) {
+        const SnakeState& snake = m_snakes[t_index];
+
+        hash_key(Zobrist::length(t_index, snake.length) ^ Zobrist::health(t_index, snake.health));
+
+        unsigned int cell = snake.tail;
+        for (unsigned int i = snake.stacked + 1; i < snake.length; i++) {
+            const Direction link = get_link(cell);
+            hash_link(cell, t_index, link);
+            m_occupied.reset(cell);
+            cell = m_geometry.neighbour(cell, link);
+        }
+
+        m_snakes[t_index] = SnakeState{};
+        m_alive &= ~(1u << t_index);
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::randomly_place_food(unsigned int t_count, const CellSet& t_blocked) {
+        // Free cells are found a word at a time and sampled by rank, so no cell is visited individually
+        const unsigned int cellCount = m_geometry.get_cell_count();
+        CellSet free;
+        for (unsigned int i = 0; i < CellSet::WORD_COUNT; i++) {
+            const uint64_t inBounds =
+                (cellCount >= (i + 1) * 64) ? ~uint64_t{0} :
+                (cellCount > i * 64) ? (uint64_t{1} << (cellCount - i * 64)) - 1 :
+                0;
+            free.words[i] = inBounds & ~t_blocked.words[i] & ~m_food.words[i];
+        }
+
+        unsigned int freeCount = free.count();
+        const unsigned int foodToAdd = std::min(freeCount, t_count);
+        for (unsigned int i = 0; i < foodToAdd; i++) {
+            const unsigned int cell = free.select(m_rng.below(freeCount--));
+            free.reset(cell);
+            m_food.set(cell);
+            hash_food(cell);
+        }
+        m_foodCount += foodToAdd;
+    }
+
+    template <class Geometry>
+    void BasicBitBoard<Geometry>::spawn_food(const CellSet& t_blocked) {
+        if (m_ruleset.spawnFood) {
+            if (m_foodCount < m_ruleset.minFood) {
+                randomly_place_food(m_ruleset.minFood - m_foodCount, t_blocked);
+            }
+            else if (m_rng.below(100) < m_ruleset.foodSpawnChance) {
+                randomly_place_food(1, t_blocked);
+            }
+        }
+    }
+
+    template <class Geometry>
+    bool BasicBitBoard<Geometry>::equals(const BasicBitBoard& t_other) const {
+        if (!(
+            (m_ruleset == t_other.m_ruleset) &&
+            (m_snakeCount == t_other.m_snakeCount) &&
+            (m_alive == t_other.m_alive) &&
+            (m_foodCount == t_other.m_foodCount) &&
+            (m_occupied == t_other.m_occupied) &&
+            (m_food == t_other.m_food)
+        )) {
+            return false;
+        }
+
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            const SnakeState& s1 = m_snakes[i];
+            const SnakeState& s2 = t_other.m_snakes[i];
+            if (
+                (s1.head != s2.head) ||
+                (s1.tail != s2.tail) ||
+                (s1.length != s2.length) ||
+                (s1.stacked != s2.stacked) ||
+                (s1.health != s2.health)
+            ) {
+                return false;
+            }
+        }
+
+        // Only compare links where they are meaningful
+        CellSet body = m_occupied;
+        for (unsigned int i = 0; i < m_snakeCount; i++) {
+            if (is_alive(i)) {
+                body.reset(m_snakes[i].head);
+            }
+        }
+        for (unsigned int w = 0; w < CellSet::WORD_COUNT; w++) {
+            for (unsigned int plane = 0; plane < 2; plane++) {
+                if ((m_links[plane].words[w] ^ t_other.m_links[plane].words[w]) & body.words[w]) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    template class BasicBitBoard<FixedGeometry<7, 7>>;
+    template class BasicBitBoard<FixedGeometry<11, 11>>;
+    template class BasicBitBoard<FixedGeometry<19, 19>>;
+    template class BasicBitBoard<DynamicGeometry>;
+
+}
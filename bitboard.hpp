@@ -0,0 +1,290 @@
+#ifndef BITBOARD_INCLUDED
+#define BITBOARD_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include "geometry.hpp"
+#include "rng.hpp"
+#include "simulator.hpp"
+
+namespace Simulator {
+
+    // Set of the first N board cells, one bit per cell packed into 64 bit words
+    template <unsigned int N>
+    struct BasicCellSet {
+        static constexpr unsigned int WORD_COUNT = (N + 63) / 64;
+
+        std::array<uint64_t, WORD_COUNT> words{};
+
+        void set(unsigned int t_cell) {
+            words[t_cell / 64] |= (uint64_t{1} << (t_cell % 64));
+        }
+
+        void reset(unsigned int t_cell) {
+            words[t_cell / 64] &= ~(uint64_t{1} << (t_cell % 64));
+        }
+
+        [[nodiscard]] bool test(unsigned int t_cell) const {
+            return (words[t_cell / 64] >> (t_cell % 64)) & 1;
+        }
+
+        [[nodiscard]] unsigned int count() const {
+            unsigned int result = 0;
+            for (const uint64_t word : words) {
+                result += __builtin_popcountll(word);
+            }
+            return result;
+        }
+
+        // Returns the member with t_rank members before it, t_rank must be less than count()
+        [[nodiscard]] unsigned int select(unsigned int t_rank) const {
+            unsigned int i = 0;
+            unsigned int wordCount = __builtin_popcountll(words[0]);
+            while (t_rank >= wordCount) {
+                t_rank -= wordCount;
+                wordCount = __builtin_popcountll(words[++i]);
+            }
+
+            uint64_t word = words[i];
+            for (; t_rank > 0; t_rank--) {
+                word &= word - 1;
+            }
+            return i * 64 + __builtin_ctzll(word);
+        }
+
+        [[nodiscard]] bool any() const {
+            for (const uint64_t word : words) {
+                if (word != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        BasicCellSet& operator|=(const BasicCellSet& t_other) {
+            for (unsigned int i = 0; i < WORD_COUNT; i++) {
+                words[i] |= t_other.words[i];
+            }
+            return *this;
+        }
+
+        BasicCellSet& operator&=(const BasicCellSet& t_other) {
+            for (unsigned int i = 0; i < WORD_COUNT; i++) {
+                words[i] &= t_other.words[i];
+            }
+            return *this;
+        }
+
+        // Removes every member of t_other
+        BasicCellSet& and_not(const BasicCellSet& t_other) {
+            for (unsigned int i = 0; i < WORD_COUNT; i++) {
+                words[i] &= ~t_other.words[i];
+            }
+            return *this;
+        }
+
+        // Shifts turn member c into c + t_count or c - t_count, t_count must
+        // be below 64. Members shifted out of the words are dropped, callers
+        // mask out members shifted past cell N - 1 within the last word.
+        BasicCellSet& operator<<=(unsigned int t_count) {
+            if (t_count == 0) return *this;
+            for (unsigned int i = WORD_COUNT - 1; i > 0; i--) {
+                words[i] = (words[i] << t_count) | (words[i - 1] >> (64 - t_count));
+            }
+            words[0] <<= t_count;
+            return *this;
+        }
+
+        BasicCellSet& operator>>=(unsigned int t_count) {
+            if (t_count == 0) return *this;
+            for (unsigned int i = 0; i + 1 < WORD_COUNT; i++) {
+                words[i] = (words[i] >> t_count) | (words[i + 1] << (64 - t_count));
+            }
+            words[WORD_COUNT - 1] >>= t_count;
+            return *this;
+        }
+
+        friend bool operator==(const BasicCellSet& t_s1, const BasicCellSet& t_s2) {
+            return t_s1.words == t_s2.words;
+        }
+    };
+
+    using CellSet = BasicCellSet<MAX_BOARD_CELLS>;
+
+    // Space held by each snake, see BasicBitBoard::get_territory. Indexed by
+    // snake, zero for eliminated snakes. Both counts include the head.
+    struct Territory {
+        std::array<uint16_t, MAX_SNAKES> reachable; // Cells the snake can get to, ignoring where the other snakes go
+        std::array<uint16_t, MAX_SNAKES> owned; // Cells the snake gets to strictly before every other snake
+    };
+
+    // Compact board used by the search. Bodies are stored as a single occupancy
+    // bitboard plus two bit planes holding, for every body cell, the direction
+    // to the next segment towards the head. A snake is then just its head, tail
+    // and the number of segments stacked on its tail, so copying a board is a
+    // memcpy and moving a snake is O(1). Links are only meaningful on body
+    // cells other than heads, so vacating a cell never has to clear them.
+    // Geometry is one of the geometries in geometry.hpp, with a FixedGeometry
+    // the bit sets are sized for the board and neighbours come from a table.
+    template <class Geometry>
+    class BasicBitBoard {
+        using CellSet = BasicCellSet<Geometry::CAPACITY>;
+
+        struct SnakeState {
+            uint16_t head;
+            uint16_t tail;
+            uint16_t length;
+            uint16_t stacked; // Segments sharing the tail cell
+            int16_t health;
+        };
+    public:
+        // State overwritten by make_move, enough for unmake_move to restore the board exactly
+        struct Undo {
+            std::array<SnakeState, MAX_SNAKES> snakes;
+            std::array<Direction, MAX_SNAKES> headLinks;
+            CellSet food;
+            uint64_t hash;
+            std::array<uint64_t, SYMMETRY_COUNT> symmetricHashes;
+            Rng rng;
+            uint16_t foodCount;
+            uint8_t alive;
+        };
+
+        // Snake i of the BitBoard is snake i of t_board, t_seed seeds the generator used to spawn food
+        explicit BasicBitBoard(const Board& t_board, uint64_t t_seed=0);
+
+        // Moves are indexed by snake, entries for eliminated snakes are ignored
+        void update(const MoveArray& t_moves);
+
+        // Same as update, the returned record undoes the move when passed to unmake_move
+        Undo make_move(const MoveArray& t_moves);
+        // Must be given the records of the most recent moves in reverse order
+        void unmake_move(const Undo& t_undo);
+
+        [[nodiscard]] Ruleset get_ruleset() const;
+        [[nodiscard]] bool is_in_bounds(Position t_position) const;
+        [[nodiscard]] bool is_safe_cell(unsigned int t_index, Position t_position) const;
+        // Bit i is set if moving in Direction i is safe for snake t_index, in the sense of is_safe_cell
+        [[nodiscard]] unsigned int get_safe_move_mask(unsigned int t_index) const;
+
+        // Number of snakes the board was created with, including eliminated ones
+        [[nodiscard]] unsigned int get_snake_count() const;
+        [[nodiscard]] bool is_alive(unsigned int t_index) const;
+
+        [[nodiscard]] Position get_head(unsigned int t_index) const;
+        [[nodiscard]] unsigned int get_length(unsigned int t_index) const;
+        [[nodiscard]] int get_health(unsigned int t_index) const;
+
+        [[nodiscard]] bool has_food(Position t_position) const;
+        [[nodiscard]] unsigned int get_food_count() const;
+        // Food with the smallest grid distance to t_position, looking only at cells holding food
+        [[nodiscard]] std::optional<Position> get_closest_food(Position t_position) const;
+
+        // Grows every snake's area from its head one cell a turn, all snakes
+        // at once, with bit set dilation. A body segment is a wall until the
+        // turn its snake's tail would have left it if no snake ate. Areas only
+        // grow from the cells they gained on the turn before, so a wall that
+        // opens after an area has passed it stays shut to that area. A cell
+        // entered by several snakes on the same turn is owned by none and
+        // blocks them all, as in a Voronoi partition.
+        [[nodiscard]] Territory get_territory() const;
+
+        // Zobrist hash of the board, kept up to date by update
+        [[nodiscard]] uint64_t get_hash() const;
+        // Zobrist hash of the board transformed by each of its symmetries,
+        // entry 0 is get_hash(). Built from scratch unless they are tracked,
+        // and only the first get_symmetry_count(w, h) entries are set, the others are 0.
+        [[nodiscard]] std::array<uint64_t, SYMMETRY_COUNT> get_symmetric_hashes() const;
+        // While tracked, make_move keeps the symmetric hashes up to date, which
+        // makes every move hash each image of what it changes
+        void track_symmetric_hashes(bool t_track);
+
+        // Returns the index of the snake that has won the game
+        // If there is no winner then get_snake_count() is returned
+        [[nodiscard]] unsigned int get_winner() const;
+        [[nodiscard]] bool is_game_over() const;
+
+        // Returns true if t_board has the dimensions of Geometry and fits within the capacity of a BitBoard
+        [[nodiscard]] static bool is_supported(const Board& t_board);
+
+        [[nodiscard]] std::string to_string() const;
+
+        friend bool operator==(const BasicBitBoard& t_b1, const BasicBitBoard& t_b2) {
+            return t_b1.equals(t_b2);
+        }
+    private:
+        // Cells that can be shifted in each direction without leaving the board
+        struct ShiftMasks {
+            CellSet board;
+            CellSet notFirstColumn;
+            CellSet notLastColumn;
+        };
+
+        [[nodiscard]] static ShiftMasks make_shift_masks(const Geometry& t_geometry);
+        // t_cells along with every cell next to one of them
+        [[nodiscard]] CellSet dilate(const CellSet& t_cells, const ShiftMasks& t_masks) const;
+
+        [[nodiscard]] bool equals(const BasicBitBoard& t_other) const;
+
+        [[nodiscard]] bool is_safe_cell(unsigned int t_index, unsigned int t_cell) const;
+
+        [[nodiscard]] Direction get_link(unsigned int t_cell) const;
+        void set_link(unsigned int t_cell, Direction t_direction);
+
+        [[nodiscard]] uint64_t compute_hash() const;
+        [[nodiscard]] std::array<uint64_t, SYMMETRY_COUNT> compute_symmetric_hashes() const;
+        [[nodiscard]] unsigned int transform_cell(unsigned int t_symmetry, unsigned int t_cell) const;
+
+        // Change the hash and the tracked symmetric hashes, which see the
+        // images of the cells and links. hash_key is for keys of no cell.
+        void hash_key(uint64_t t_key);
+        void hash_food(unsigned int t_cell);
+        void hash_head(unsigned int t_cell, unsigned int t_index);
+        void hash_link(unsigned int t_cell, unsigned int t_index, Direction t_link);
+
+        void pop_tail(unsigned int t_index);
+        void remove_snake(unsigned int t_index);
+        void randomly_place_food(unsigned int t_count, const CellSet& t_blocked);
+        void spawn_food(const CellSet& t_blocked);
+
+        Ruleset m_ruleset;
+        Geometry m_geometry;
+
+        CellSet m_occupied;
+        CellSet m_links[2];
+        CellSet m_food;
+
+        std::array<SnakeState, MAX_SNAKES> m_snakes;
+        uint64_t m_hash;
+        std::array<uint64_t, SYMMETRY_COUNT> m_symmetricHashes; // Entry 0 is unused, m_hash is kept instead
+        Rng m_rng;
+        uint16_t m_foodCount;
+        uint8_t m_snakeCount;
+        uint8_t m_alive; // Bit i set if snake i is still in the game
+        uint8_t m_symmetryCount; // Symmetries tracked in m_symmetricHashes, 0 if they are not
+    };
+
+    extern template class BasicBitBoard<FixedGeometry<7, 7>>;
+    extern template class BasicBitBoard<FixedGeometry<11, 11>>;
+    extern template class BasicBitBoard<FixedGeometry<19, 19>>;
+    extern template class BasicBitBoard<DynamicGeometry>;
+
+    // Board for any supported size
+    using BitBoard = BasicBitBoard<DynamicGeometry>;
+
+    static_assert(std::is_trivially_copyable_v<BitBoard>);
+
+    struct BitBoardHash {
+        template <class Geometry>
+        size_t operator()(const BasicBitBoard<Geometry>& t_board) const noexcept {
+            return t_board.get_hash();
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ai.hpp"
+#include "opening_book.hpp"
+#include "simulator.hpp"
+
+// Defaults for the arguments, in order: the book to write, the games played
+// per snake count, the turns recorded per game and the search time per move
+constexpr unsigned int GAME_COUNT = 8;
+constexpr unsigned int TURN_COUNT = 15;
+constexpr unsigned int COMPUTE_TIME = 2000;
+
+// Standard 11x11 start: the snakes start in the corners or in the middles of
+// the edges, with a food next to each snake towards the centre and one food
+// in the centre
+Simulator::Board standard_start(unsigned int t_snakeCount, Simulator::Rng& t_rng, uint64_t t_seed) {
+    constexpr unsigned int SIZE = 11;
+    constexpr Simulator::Position CENTRE{5, 5};
+
+    std::vector<Simulator::Position> starts = (t_rng.below(2) == 0)
+        ? std::vector<Simulator::Position>{{1, 1}, {1, 9}, {9, 1}, {9, 9}}
+        : std::vector<Simulator::Position>{{1, 5}, {5, 1}, {5, 9}, {9, 5}};
+    for (unsigned int i = starts.size() - 1; i > 0; i--) {
+        std::swap(starts[i], starts[t_rng.below(i + 1)]);
+    }
+
+    const auto centreDistance = [&](Simulator::Position t_position) {
+        return std::abs(t_position.x - CENTRE.x) + std::abs(t_position.y - CENTRE.y);
+    };
+
+    std::vector<Simulator::Snake> snakes;
+    Grid<bool> food(SIZE, SIZE);
+    unsigned int foodCount = 0;
+    for (unsigned int i = 0; i < t_snakeCount; i++) {
+        const Simulator::Position head = starts[i];
+        snakes.emplace_back(head, 3, 100);
+
+        std::vector<Simulator::Position> options;
+        for (const int dx : {-1, 1}) {
+            for (const int dy : {-1, 1}) {
+                const Simulator::Position option{head.x + dx, head.y + dy};
+                if (option != CENTRE && centreDistance(option) <= centreDistance(head)) {
+                    options.push_back(option);
+                }
+            }
+        }
+        const Simulator::Position chosen = options[t_rng.below(options.size())];
+        if (!food(chosen.x, chosen.y)) {
+            food(chosen.x, chosen.y) = true;
+            foodCount++;
+        }
+    }
+    food(CENTRE.x, CENTRE.y) = true;
+    foodCount++;
+
+    Simulator::Ruleset ruleset = Simulator::DEFAULT_RULESET;
+    ruleset.noSnakes = t_snakeCount;
+    return Simulator::Board{snakes, Simulator::FoodGrid{food, foodCount}, ruleset, t_seed};
+}
+
+int main(int argc, char* argv[]) {
+    const std::string path = (argc > 1) ? argv[1] : "book.bin";
+    const unsigned int gameCount = (argc > 2) ? std::stoul(argv[2]) : GAME_COUNT;
+    const unsigned int turnCount = (argc > 3) ? std::stoul(argv[3]) : TURN_COUNT;
+    const unsigned int computeTime = (argc > 4) ? std::stoul(argv[4]) : COMPUTE_TIME;
+
+    AI::MCTSParameters params = AI::DEFAULT_PARAMETERS;
+    params.computeTime = computeTime;
+    params.threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Every player of every position reached in the first turns of self play
+    // games is searched once, the positions are those the server will see
+    // when its opponents play as well as a long search does
+    std::unordered_map<uint64_t, Simulator::Direction> book;
+    Simulator::Rng rng(0);
+    uint64_t seed = 0;
+
+    for (unsigned int snakeCount = 2; snakeCount <= 4; snakeCount++) {
+        for (unsigned int game = 0; game < gameCount; game++) {
+            Simulator::Board board = standard_start(snakeCount, rng, seed++);
+
+            for (unsigned int turn = 0; turn < turnCount && !board.is_game_over(); turn++) {
+                Simulator::MoveArray moves{};
+                for (unsigned int i = 0; i < board.get_snake_count(); i++) {
+                    if (!board.is_alive(i)) continue;
+
+                    // Moves are stored as played on the image of the position the key was taken from
+                    const AI::BookKey key = AI::book_key(board, i);
+                    const auto it = book.find(key.hash);
+                    if (it != book.end()) {
+                        moves[i] = Simulator::transform_direction(Simulator::inverse_symmetry(key.symmetry), it->second);
+                        continue;
+                    }
+
+                    params.seed = seed++;
+                    moves[i] = AI::mcts_suct_player(board, i, params);
+                    book.emplace(key.hash, Simulator::transform_direction(key.symmetry, moves[i]));
+                }
+                board.update(moves);
+            }
+
+            std::cout << snakeCount << " snakes, game " << game + 1 << " / " << gameCount << ": " << book.size() << " positions\n";
+        }
+    }
+
+    if (!AI::OpeningBook::write(path, {book.begin(), book.end()})) {
+        std::cerr << "Could not write the book to '" << path << "'\n";
+        return 1;
+    }
+
+    std::cout << "Wrote " << book.size() << " positions to '" << path << "'\n";
+    return 0;
+}
@@ -0,0 +1,192 @@
+#ifndef GEOMETRY_INCLUDED
+#define GEOMETRY_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "simulator.hpp"
+
+// Board geometries the search board is specialised on. A geometry maps
+// positions to cells, indexed y * w + x, and gives the cell next to a cell in
+// each direction. FixedGeometry knows its dimensions at compile time and reads
+// neighbours from a constexpr table, DynamicGeometry works out the same values
+// for any board up to the maximum size.
+namespace Simulator {
+
+    // Neighbour of a cell on the edge of the board in the direction of that edge
+    constexpr unsigned int OFF_BOARD = std::numeric_limits<uint16_t>::max();
+
+    template <unsigned int W, unsigned int H>
+    constexpr std::array<uint16_t, W * H * 4> generate_neighbours() {
+        std::array<uint16_t, W * H * 4> result{};
+        for (unsigned int y = 0; y < H; y++) {
+            for (unsigned int x = 0; x < W; x++) {
+                const unsigned int cell = y * W + x;
+                result[cell * 4 + static_cast<unsigned int>(Direction::UP)] = (y > 0) ? cell - W : OFF_BOARD;
+                result[cell * 4 + static_cast<unsigned int>(Direction::DOWN)] = (y + 1 < H) ? cell + W : OFF_BOARD;
+                result[cell * 4 + static_cast<unsigned int>(Direction::LEFT)] = (x > 0) ? cell - 1 : OFF_BOARD;
+                result[cell * 4 + static_cast<unsigned int>(Direction::RIGHT)] = (x + 1 < W) ? cell + 1 : OFF_BOARD;
+            }
+        }
+        return result;
+    }
+
+    template <unsigned int W, unsigned int H>
+    class FixedGeometry {
+    public:
+        static_assert(W * H <= MAX_BOARD_CELLS);
+
+        // Number of cells storage has to be sized for
+        static constexpr unsigned int CAPACITY = W * H;
+
+        [[nodiscard]] static constexpr bool supports(unsigned int t_w, unsigned int t_h) {
+            return t_w == W && t_h == H;
+        }
+
+        // The dimensions are only given so that every geometry is constructed the same way
+        constexpr FixedGeometry(unsigned int, unsigned int) {}
+
+        [[nodiscard]] constexpr unsigned int get_width() const {
+            return W;
+        }
+
+        [[nodiscard]] constexpr unsigned int get_height() const {
+            return H;
+        }
+
+        [[nodiscard]] constexpr unsigned int get_cell_count() const {
+            return W * H;
+        }
+
+        [[nodiscard]] constexpr bool is_in_bounds(Position t_position) const {
+            return static_cast<unsigned int>(t_position.x) < W && static_cast<unsigned int>(t_position.y) < H;
+        }
+
+        [[nodiscard]] constexpr unsigned int to_cell(Position t_position) const {
+            return t_position.y * W + t_position.x;
+        }
+
+        [[nodiscard]] constexpr Position to_position(unsigned int t_cell) const {
+            return Position{static_cast<int>(t_cell % W), static_cast<int>(t_cell / W)};
+        }
+
+        [[nodiscard]] constexpr unsigned int neighbour(unsigned int t_cell, Direction t_direction) const {
+            return NEIGHBOURS[t_cell * 4 + static_cast<unsigned int>(t_direction)];
+        }
+    private:
+        static constexpr std::array<uint16_t, W * H * 4> NEIGHBOURS = generate_neighbours<W, H>();
+    };
+
+    class DynamicGeometry {
+    public:
+        static constexpr unsigned int CAPACITY = MAX_BOARD_CELLS;
+
+        [[nodiscard]] static constexpr bool supports(unsigned int t_w, unsigned int t_h) {
+            return t_w <= MAX_BOARD_WIDTH && t_h <= MAX_BOARD_HEIGHT;
+        }
+
+        constexpr DynamicGeometry(unsigned int t_w, unsigned int t_h)
+            : m_w(t_w)
+            , m_h(t_h)
+        {}
+
+        [[nodiscard]] constexpr unsigned int get_width() const {
+            return m_w;
+        }
+
+        [[nodiscard]] constexpr unsigned int get_height() const {
+            return m_h;
+        }
+
+        [[nodiscard]] constexpr unsigned int get_cell_count() const {
+            return m_w * m_h;
+        }
+
+        [[nodiscard]] constexpr bool is_in_bounds(Position t_position) const {
+            return static_cast<unsigned int>(t_position.x) < m_w && static_cast<unsigned int>(t_position.y) < m_h;
+        }
+
+        [[nodiscard]] constexpr unsigned int to_cell(Position t_position) const {
+            return t_position.y * m_w + t_position.x;
+        }
+
+        [[nodiscard]] constexpr Position to_position(unsigned int t_cell) const {
+            return Position{static_cast<int>(t_cell % m_w), static_cast<int>(t_cell / m_w)};
+        }
+
+        [[nodiscard]] constexpr unsigned int neighbour(unsigned int t_cell, Direction t_direction) const {
+            switch (t_direction) {
+                case Direction::UP:
+                    return (t_cell >= m_w) ? t_cell - m_w : OFF_BOARD;
+                case Direction::DOWN:
+                    return (t_cell + m_w < get_cell_count()) ? t_cell + m_w : OFF_BOARD;
+                case Direction::LEFT:
+                    return (t_cell % m_w != 0) ? t_cell - 1 : OFF_BOARD;
+                case Direction::RIGHT:
+                    return (t_cell % m_w + 1 < m_w) ? t_cell + 1 : OFF_BOARD;
+            }
+            return OFF_BOARD;
+        }
+    private:
+        uint8_t m_w;
+        uint8_t m_h;
+    };
+
+    // Symmetries of a board, the rotations and reflections that map it onto
+    // itself. Bit 2 of a symmetry transposes x and y, then bit 0 mirrors x and
+    // bit 1 mirrors y. Only square boards can be transposed, so their
+    // symmetries are 0 to 7 and those of other boards 0 to 3. 0 is the identity.
+    constexpr unsigned int SYMMETRY_COUNT = 8;
+    constexpr unsigned int IDENTITY_SYMMETRY = 0;
+
+    constexpr unsigned int get_symmetry_count(unsigned int t_w, unsigned int t_h) {
+        return (t_w == t_h) ? SYMMETRY_COUNT : SYMMETRY_COUNT / 2;
+    }
+
+    // Undoes t_symmetry, transposing first swaps which axis each mirror applies to
+    constexpr unsigned int inverse_symmetry(unsigned int t_symmetry) {
+        if ((t_symmetry & 4) == 0) {
+            return t_symmetry;
+        }
+        return 4 | ((t_symmetry & 1) << 1) | ((t_symmetry >> 1) & 1);
+    }
+
+    // Image of t_position on a t_w x t_h board
+    constexpr Position transform_position(unsigned int t_symmetry, Position t_position, unsigned int t_w, unsigned int t_h) {
+        Position result = ((t_symmetry & 4) != 0) ? Position{t_position.y, t_position.x} : t_position;
+        if ((t_symmetry & 1) != 0) {
+            result.x = static_cast<int>(t_w) - 1 - result.x;
+        }
+        if ((t_symmetry & 2) != 0) {
+            result.y = static_cast<int>(t_h) - 1 - result.y;
+        }
+        return result;
+    }
+
+    // Direction taken by the image of a snake moving in t_direction
+    constexpr Direction transform_direction(unsigned int t_symmetry, Direction t_direction) {
+        const Position step = update_position(Position{0, 0}, t_direction);
+        return direction_to(Position{0, 0}, transform_position(t_symmetry, step, 1, 1));
+    }
+
+    // Calls t_function with the geometry of a t_w x t_h board, the common
+    // sizes get a FixedGeometry and anything else a DynamicGeometry.
+    // t_function must return the same type for every geometry.
+    template <typename Function>
+    decltype(auto) dispatch_geometry(unsigned int t_w, unsigned int t_h, Function&& t_function) {
+        if (FixedGeometry<11, 11>::supports(t_w, t_h)) {
+            return t_function(FixedGeometry<11, 11>(t_w, t_h));
+        }
+        if (FixedGeometry<7, 7>::supports(t_w, t_h)) {
+            return t_function(FixedGeometry<7, 7>(t_w, t_h));
+        }
+        if (FixedGeometry<19, 19>::supports(t_w, t_h)) {
+            return t_function(FixedGeometry<19, 19>(t_w, t_h));
+        }
+        return t_function(DynamicGeometry(t_w, t_h));
+    }
+
+}
+
+#endif
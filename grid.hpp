@@ -1,6 +1,15 @@
 #ifndef GRID_INCLUDED
 #define GRID_INCLUDED
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 template <typename T>
 class Grid {
 public:
@@ -41,44 +50,235 @@ private:
     std::vector<T> m_grid;
 };
 
-template <>
-class Grid<bool> {
+// Grid of bits with each row packed into one 64 bit word, bit x of row y
+// holding cell (x, y). Whole board operations work a row at a time, using
+// AVX2 for four rows at once when the compiler targets it.
+class BitGrid {
 public:
-    Grid(unsigned int t_w, unsigned int t_h) 
+    static constexpr unsigned int MAX_WIDTH = 64;
+
+    class reference {
+    public:
+        reference(uint64_t& t_row, uint64_t t_bit)
+            : m_row(t_row)
+            , m_bit(t_bit)
+        {
+            ;
+        }
+
+        reference& operator=(bool t_value) {
+            m_row = t_value ? (m_row | m_bit) : (m_row & ~m_bit);
+            return *this;
+        }
+
+        reference& operator=(const reference& t_other) {
+            return *this = static_cast<bool>(t_other);
+        }
+
+        operator bool() const {
+            return (m_row & m_bit) != 0;
+        }
+    private:
+        uint64_t& m_row;
+        uint64_t m_bit;
+    };
+
+    // t_w must be at most MAX_WIDTH
+    BitGrid(unsigned int t_w, unsigned int t_h)
         : m_w(t_w)
-        , m_grid(t_w * t_h)
+        , m_rowMask((t_w >= MAX_WIDTH) ? ~uint64_t{0} : (uint64_t{1} << t_w) - 1)
+        , m_rows(t_h)
     {
-        ;
+        assert(t_w <= MAX_WIDTH);
     }
-    
-    std::vector<bool>::reference operator()(unsigned int t_x, unsigned int t_y) {
-        return m_grid[t_y * get_width() + t_x];
+
+    reference operator()(unsigned int t_x, unsigned int t_y) {
+        return reference(m_rows[t_y], uint64_t{1} << t_x);
     }
-    
+
     [[nodiscard]] bool operator()(unsigned int t_x, unsigned int t_y) const {
-        return m_grid[t_y * get_width() + t_x];
+        return (m_rows[t_y] >> t_x) & 1;
     }
-    
+
     [[nodiscard]] unsigned int get_width() const {
         return m_w;
     }
-    
+
     [[nodiscard]] unsigned int get_height() const {
-        return m_grid.size() / m_w;
+        return m_rows.size();
     }
 
     [[nodiscard]] unsigned int size() const {
-        return m_grid.size();
+        return m_w * m_rows.size();
+    }
+
+    // Bit x of the result is cell (x, t_y)
+    [[nodiscard]] uint64_t get_row(unsigned int t_y) const {
+        return m_rows[t_y];
+    }
+
+    void set_row(unsigned int t_y, uint64_t t_row) {
+        m_rows[t_y] = t_row & m_rowMask;
+    }
+
+    // Sets every cell
+    void fill() {
+        std::fill(m_rows.begin(), m_rows.end(), m_rowMask);
+    }
+
+    void clear() {
+        std::fill(m_rows.begin(), m_rows.end(), 0);
+    }
+
+    // Grids combined with these must have the same dimensions
+    BitGrid& operator&=(const BitGrid& t_other) {
+        return apply(t_other, And{});
+    }
+
+    BitGrid& operator|=(const BitGrid& t_other) {
+        return apply(t_other, Or{});
+    }
+
+    BitGrid& operator^=(const BitGrid& t_other) {
+        return apply(t_other, Xor{});
     }
 
-    bool operator==(const Grid<bool>& t_other) const {
+    // Clears every cell set in t_other
+    BitGrid& and_not(const BitGrid& t_other) {
+        return apply(t_other, AndNot{});
+    }
+
+    // Shifts move every cell one step in the named direction, with y growing
+    // downwards, and cells moved off the edge are dropped
+    BitGrid& shift_up() {
+        if (!m_rows.empty()) {
+            std::copy(m_rows.begin() + 1, m_rows.end(), m_rows.begin());
+            m_rows.back() = 0;
+        }
+        return *this;
+    }
+
+    BitGrid& shift_down() {
+        if (!m_rows.empty()) {
+            std::copy_backward(m_rows.begin(), m_rows.end() - 1, m_rows.end());
+            m_rows.front() = 0;
+        }
+        return *this;
+    }
+
+    BitGrid& shift_left() {
+        unsigned int y = 0;
+#ifdef __AVX2__
+        for (; y + 4 <= m_rows.size(); y += 4) {
+            const __m256i rows = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_rows[y]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&m_rows[y]), _mm256_srli_epi64(rows, 1));
+        }
+#endif
+        for (; y < m_rows.size(); y++) {
+            m_rows[y] >>= 1;
+        }
+        return *this;
+    }
+
+    BitGrid& shift_right() {
+        unsigned int y = 0;
+#ifdef __AVX2__
+        const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(m_rowMask));
+        for (; y + 4 <= m_rows.size(); y += 4) {
+            const __m256i rows = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_rows[y]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&m_rows[y]), _mm256_and_si256(_mm256_slli_epi64(rows, 1), mask));
+        }
+#endif
+        for (; y < m_rows.size(); y++) {
+            m_rows[y] = (m_rows[y] << 1) & m_rowMask;
+        }
+        return *this;
+    }
+
+    // Number of set cells
+    [[nodiscard]] unsigned int count() const {
+        unsigned int result = 0;
+        for (const uint64_t row : m_rows) {
+            result += __builtin_popcountll(row);
+        }
+        return result;
+    }
+
+    [[nodiscard]] bool any() const {
+        return std::any_of(m_rows.begin(), m_rows.end(), [](uint64_t t_row) { return t_row != 0; });
+    }
+
+    // Returns the first set cell in row major order as y * w + x, or size() if there is none
+    [[nodiscard]] unsigned int find_first() const {
+        for (unsigned int y = 0; y < m_rows.size(); y++) {
+            if (m_rows[y] != 0) {
+                return y * m_w + __builtin_ctzll(m_rows[y]);
+            }
+        }
+        return size();
+    }
+
+    bool operator==(const BitGrid& t_other) const {
         return
             (m_w == t_other.m_w) &&
-            (m_grid == t_other.m_grid);
+            (m_rows == t_other.m_rows);
     }
 private:
+    // Row operations, with an overload for four rows at once when AVX2 is available
+    struct And {
+        uint64_t operator()(uint64_t t_a, uint64_t t_b) const { return t_a & t_b; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i t_a, __m256i t_b) const { return _mm256_and_si256(t_a, t_b); }
+#endif
+    };
+
+    struct Or {
+        uint64_t operator()(uint64_t t_a, uint64_t t_b) const { return t_a | t_b; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i t_a, __m256i t_b) const { return _mm256_or_si256(t_a, t_b); }
+#endif
+    };
+
+    struct Xor {
+        uint64_t operator()(uint64_t t_a, uint64_t t_b) const { return t_a ^ t_b; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i t_a, __m256i t_b) const { return _mm256_xor_si256(t_a, t_b); }
+#endif
+    };
+
+    struct AndNot {
+        uint64_t operator()(uint64_t t_a, uint64_t t_b) const { return t_a & ~t_b; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i t_a, __m256i t_b) const { return _mm256_andnot_si256(t_b, t_a); }
+#endif
+    };
+
+    template <typename Operation>
+    BitGrid& apply(const BitGrid& t_other, Operation t_operation) {
+        unsigned int y = 0;
+#ifdef __AVX2__
+        for (; y + 4 <= m_rows.size(); y += 4) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_rows[y]));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&t_other.m_rows[y]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&m_rows[y]), t_operation(a, b));
+        }
+#endif
+        for (; y < m_rows.size(); y++) {
+            m_rows[y] = t_operation(m_rows[y], t_other.m_rows[y]);
+        }
+        return *this;
+    }
+
     unsigned int m_w;
-    std::vector<bool> m_grid;
+    uint64_t m_rowMask;
+    std::vector<uint64_t> m_rows;
+};
+
+// Boolean grids are bit grids
+template <>
+class Grid<bool> : public BitGrid {
+public:
+    using BitGrid::BitGrid;
 };
 
 #endif
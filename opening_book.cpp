@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bitboard.hpp"
+#include "opening_book.hpp"
+
+namespace AI {
+
+    namespace {
+
+        constexpr std::array<char, 8> BOOK_MAGIC {'S', 'N', 'K', 'B', 'O', 'O', 'K', '1'};
+
+        struct BookHeader {
+            std::array<char, 8> magic;
+            uint64_t size;
+        };
+
+    }
+
+    BookKey book_key(const Simulator::Board& t_board, unsigned int t_playerIndex) {
+        // The other living snakes keep their order
+        std::vector<Simulator::Snake> snakes;
+        snakes.reserve(t_board.get_snake_count());
+        snakes.push_back(t_board.get_snake(t_playerIndex));
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (i != t_playerIndex && t_board.is_alive(i)) {
+                snakes.push_back(t_board.get_snake(i));
+            }
+        }
+
+        const Simulator::Board relabelled{snakes, t_board.get_food(), t_board.get_ruleset()};
+        if (!Simulator::BitBoard::is_supported(relabelled)) {
+            return BookKey{relabelled.get_hash(), Simulator::IDENTITY_SYMMETRY};
+        }
+
+        // Ties go to the first symmetry, as in the search
+        const Simulator::Ruleset ruleset = relabelled.get_ruleset();
+        const std::array<uint64_t, Simulator::SYMMETRY_COUNT> hashes = Simulator::BitBoard(relabelled).get_symmetric_hashes();
+        BookKey result{hashes[0], Simulator::IDENTITY_SYMMETRY};
+        for (unsigned int s = 1; s < Simulator::get_symmetry_count(ruleset.w, ruleset.h); s++) {
+            if (hashes[s] < result.hash) {
+                result = BookKey{hashes[s], s};
+            }
+        }
+        return result;
+    }
+
+    OpeningBook::OpeningBook()
+        : m_data(nullptr)
+        , m_bytes(0)
+        , m_keys(nullptr)
+        , m_moves(nullptr)
+        , m_size(0)
+    {
+        ;
+    }
+
+    OpeningBook::OpeningBook(const std::string& t_path)
+        : OpeningBook()
+    {
+        const int fd = open(t_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(BookHeader)) {
+            close(fd);
+            return;
+        }
+
+        // The mapping stays valid once the file is closed
+        const size_t bytes = static_cast<size_t>(status.st_size);
+        void* data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return;
+        }
+
+        m_data = data;
+        m_bytes = bytes;
+
+        BookHeader header;
+        std::memcpy(&header, data, sizeof(BookHeader));
+        constexpr size_t ENTRY_BYTES = sizeof(uint64_t) + 1;
+        const size_t bodyBytes = bytes - sizeof(BookHeader);
+        if (header.magic != BOOK_MAGIC || bodyBytes % ENTRY_BYTES != 0 || header.size != bodyBytes / ENTRY_BYTES) {
+            unmap();
+            return;
+        }
+
+        // mmap returns page aligned memory and the header is 16 bytes, so the keys are aligned
+        m_keys = reinterpret_cast<const uint64_t*>(static_cast<const char*>(data) + sizeof(BookHeader));
+        m_moves = reinterpret_cast<const uint8_t*>(m_keys + header.size);
+        m_size = header.size;
+    }
+
+    OpeningBook::~OpeningBook() {
+        unmap();
+    }
+
+    OpeningBook::OpeningBook(OpeningBook&& t_other) noexcept
+        : m_data(std::exchange(t_other.m_data, nullptr))
+        , m_bytes(std::exchange(t_other.m_bytes, 0))
+        , m_keys(std::exchange(t_other.m_keys, nullptr))
+        , m_moves(std::exchange(t_other.m_moves, nullptr))
+        , m_size(std::exchange(t_other.m_size, 0))
+    {
+        ;
+    }
+
+    OpeningBook& OpeningBook::operator=(OpeningBook&& t_other) noexcept {
+        if (this != &t_other) {
+            unmap();
+            m_data = std::exchange(t_other.m_data, nullptr);
+            m_bytes = std::exchange(t_other.m_bytes, 0);
+            m_keys = std::exchange(t_other.m_keys, nullptr);
+            m_moves = std::exchange(t_other.m_moves, nullptr);
+            m_size = std::exchange(t_other.m_size, 0);
+        }
+        return *this;
+    }
+
+    std::optional<Simulator::Direction> OpeningBook::find(uint64_t t_hash) const {
+        const uint64_t* end = m_keys + m_size;
+        const uint64_t* it = std::lower_bound(m_keys, end, t_hash);
+        if (it == end || *it != t_hash) {
+            return std::nullopt;
+        }
+
+        const uint8_t move = m_moves[it - m_keys];
+        if (move > static_cast<uint8_t>(Simulator::Direction::RIGHT)) {
+            return std::nullopt;
+        }
+        return static_cast<Simulator::Direction>(move);
+    }
+
+    std::optional<Simulator::Direction> OpeningBook::find(const BookKey& t_key) const {
+        const std::optional<Simulator::Direction> stored = find(t_key.hash);
+        if (!stored) {
+            return std::nullopt;
+        }
+        return Simulator::transform_direction(Simulator::inverse_symmetry(t_key.symmetry), *stored);
+    }
+
+    size_t OpeningBook::size() const {
+        return m_size;
+    }
+
+    bool OpeningBook::write(const std::string& t_path, std::vector<std::pair<uint64_t, Simulator::Direction>> t_entries) {
+        // A stable sort keeps the first move of each key at the front of its run
+        std::stable_sort(t_entries.begin(), t_entries.end(), [](const auto& t_e1, const auto& t_e2) {
+            return t_e1.first < t_e2.first;
+        });
+        t_entries.erase(std::unique(t_entries.begin(), t_entries.end(), [](const auto& t_e1, const auto& t_e2) {
+            return t_e1.first == t_e2.first;
+        }), t_entries.end());
+
+        std::vector<uint64_t> keys;
+        std::vector<uint8_t> moves;
+        keys.reserve(t_entries.size());
+        moves.reserve(t_entries.size());
+        for (const auto& [key, move] : t_entries) {
+            keys.push_back(key);
+            moves.push_back(static_cast<uint8_t>(move));
+        }
+
+        std::ofstream file(t_path, std::ios::binary | std::ios::trunc);
+        const BookHeader header{BOOK_MAGIC, keys.size()};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(keys.data()), static_cast<std::streamsize>(keys.size() * sizeof(uint64_t)));
+        file.write(reinterpret_cast<const char*>(moves.data()), static_cast<std::streamsize>(moves.size()));
+
+        return static_cast<bool>(file);
+    }
+
+    void OpeningBook::unmap() {
+        if (m_data != nullptr) {
+            munmap(m_data, m_bytes);
+        }
+        m_data = nullptr;
+        m_bytes = 0;
+        m_keys = nullptr;
+        m_moves = nullptr;
+        m_size = 0;
+    }
+
+}
@@ -0,0 +1,68 @@
+#ifndef OPENING_BOOK_INCLUDED
+#define OPENING_BOOK_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "geometry.hpp"
+#include "simulator.hpp"
+
+namespace AI {
+
+    // Key of a position in the book, the move is stored as it would be played
+    // on the image of the position under symmetry
+    struct BookKey {
+        uint64_t hash;
+        unsigned int symmetry;
+    };
+
+    // Smallest Zobrist hash of the images of t_board under its symmetries,
+    // with snake t_playerIndex moved to index 0 and eliminated snakes left
+    // out, so that every player of a position, and every rotation or
+    // reflection of it, looks it up under the same key
+    BookKey book_key(const Simulator::Board& t_board, unsigned int t_playerIndex);
+
+    // Moves for positions searched ahead of time, looked up by book_key. The
+    // file is a header, the keys in increasing order and then one move per
+    // key, in the byte order of the machine that wrote it. It is mapped into
+    // memory rather than read, so opening a book costs nothing until it is
+    // used, and a lookup is a binary search over the keys.
+    class OpeningBook {
+    public:
+        // An empty book
+        OpeningBook();
+        // Maps the book at t_path, the book is empty if the file cannot be mapped or is not a book
+        explicit OpeningBook(const std::string& t_path);
+        ~OpeningBook();
+
+        OpeningBook(OpeningBook&& t_other) noexcept;
+        OpeningBook& operator=(OpeningBook&& t_other) noexcept;
+
+        OpeningBook(const OpeningBook&) = delete;
+        OpeningBook& operator=(const OpeningBook&) = delete;
+
+        [[nodiscard]] std::optional<Simulator::Direction> find(uint64_t t_hash) const;
+        // Move for the position of t_key, as played on the board it was made from
+        [[nodiscard]] std::optional<Simulator::Direction> find(const BookKey& t_key) const;
+        [[nodiscard]] size_t size() const;
+
+        // Writes t_entries as a book to t_path, keyed by hash with the moves as
+        // they are stored, the first move given for a hash is kept. Returns false if the file could not be written.
+        static bool write(const std::string& t_path, std::vector<std::pair<uint64_t, Simulator::Direction>> t_entries);
+    private:
+        void unmap();
+
+        void* m_data;
+        size_t m_bytes;
+        const uint64_t* m_keys;
+        const uint8_t* m_moves;
+        size_t m_size;
+    };
+
+}
+
+#endif
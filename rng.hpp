@@ -0,0 +1,61 @@
+#ifndef RNG_INCLUDED
+#define RNG_INCLUDED
+
+#include <cstdint>
+
+namespace Simulator {
+
+    // PCG32 random number generator. The whole state is a single 64 bit
+    // word, so every board and search can own a generator without making
+    // copies expensive, and a fixed seed always replays the same game.
+    // Satisfies UniformRandomBitGenerator for use with <random> and <algorithm>.
+    class Rng {
+    public:
+        using result_type = uint32_t;
+
+        constexpr Rng()
+            : Rng(0)
+        {}
+
+        explicit constexpr Rng(uint64_t t_seed)
+            : m_state(0)
+        {
+            step();
+            m_state += t_seed;
+            step();
+        }
+
+        constexpr result_type operator()() {
+            const uint64_t state = m_state;
+            step();
+
+            const uint32_t xorShifted = static_cast<uint32_t>(((state >> 18) ^ state) >> 27);
+            const uint32_t rotation = static_cast<uint32_t>(state >> 59);
+            return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+        }
+
+        // Returns a number in [0, t_bound) using a multiply instead of a modulo,
+        // the bias is at most t_bound / 2^32
+        constexpr uint32_t below(uint32_t t_bound) {
+            return static_cast<uint32_t>((uint64_t{(*this)()} * t_bound) >> 32);
+        }
+
+        static constexpr result_type min() {
+            return 0;
+        }
+
+        static constexpr result_type max() {
+            return UINT32_MAX;
+        }
+
+    private:
+        constexpr void step() {
+            m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+        }
+
+        uint64_t m_state;
+    };
+
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include <iostream>
+#include <optional>
 #include <string>
 
 #include "crow.h"
@@ -5,6 +7,27 @@
 #include "server_logic.hpp"
 
 int main(int argc, char* argv[]) {
+    // The engine can be chosen with the first argument, seek_food by default
+    const std::optional<AI::Engine> engine = (argc > 1) ? AI::engine_from_string(argv[1]) : AI::Engine::SEEK_FOOD;
+    if (!engine) {
+        std::cerr << "Unknown engine '" << argv[1] << "', expected seek_food, suct, tree_suct, duct or alpha_beta\n";
+        return 1;
+    }
+
+    // After the engine, "ponder" makes suct keep searching between the moves
+    // of a game and any other argument is the path of an opening book
+    bool ponder = false;
+    for (int i = 2; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "ponder") {
+            ponder = true;
+        }
+        else if (!ServerLogic::load_book(argument)) {
+            std::cerr << "Could not load an opening book from '" << argument << "'\n";
+            return 1;
+        }
+    }
+
     crow::SimpleApp app;
 
     CROW_ROUTE(app, "/")([](){
@@ -22,14 +45,15 @@ int main(int argc, char* argv[]) {
         return "ok";
     });
 
-    CROW_ROUTE(app, "/move").methods(crow::HTTPMethod::POST)([](const crow::request& req){
+    CROW_ROUTE(app, "/move").methods(crow::HTTPMethod::POST)([&engine, ponder](const crow::request& req){
         crow::json::rvalue json = crow::json::load(req.body.c_str(), req.body.length());
         
-        return R"({"move": ")" + ServerLogic::choose_move(json) + "\"}";
+        return R"({"move": ")" + ServerLogic::choose_move(json, *engine, ponder) + "\"}";
     });
 
     CROW_ROUTE(app, "/end").methods(crow::HTTPMethod::POST)([](const crow::request& req){
         CROW_LOG_INFO << "game end";
+        ServerLogic::end_game(crow::json::load(req.body.c_str(), req.body.length()));
         return "ok";
     });
 
@@ -1,19 +1,82 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include "ai.hpp"
+#include "opening_book.hpp"
 #include "server_logic.hpp"
 #include "simulator.hpp"
 
 namespace ServerLogic {
+
+    // Search tree of one game, along with the thread pondering on it between requests
+    struct GameSearch {
+        AI::SearchTree tree;
+        std::atomic<bool> stopPondering{false};
+        std::thread ponderThread;
+        std::chrono::steady_clock::time_point lastUsed;
+
+        ~GameSearch() {
+            stop_pondering();
+        }
+
+        void stop_pondering() {
+            if (ponderThread.joinable()) {
+                stopPondering = true;
+                ponderThread.join();
+                stopPondering = false;
+            }
+        }
+    };
+
+    // Pondering stops by itself if the next request never comes, for instance when a game is abandoned
+    constexpr unsigned int MAX_PONDER_TIME = 2000;
+
+    // Games that never send /end, such as dropped ones, are freed once they go this long without a request
+    constexpr std::chrono::minutes GAME_EXPIRY_TIME{1};
+
+    // Search trees of the games in progress, requests run on several threads.
+    // Held by pointer so that a pondering thread keeps its tree in place.
+    std::unordered_map<std::string, std::unique_ptr<GameSearch>> g_trees;
+    std::mutex g_treesMutex;
+
+    // Only written by load_book, before any request
+    AI::OpeningBook g_book;
+
+    std::string get_tree_key(const crow::json::rvalue& t_data);
+    // Moves the games whose last request is older than GAME_EXPIRY_TIME out of
+    // g_trees and into t_expired, g_treesMutex must be held
+    void take_expired_games(std::chrono::steady_clock::time_point t_now, std::vector<std::unique_ptr<GameSearch>>& t_expired);
     
-    std::string choose_move(const crow::json::rvalue& t_data) {
+    std::string choose_move(const crow::json::rvalue& t_data, AI::Engine t_engine, bool t_ponder) {
         const unsigned int w = t_data["board"]["width"].u();
         const unsigned int h = t_data["board"]["height"].u();
         
-        std::unordered_map<std::string, Simulator::Snake> snakes;
+        // Battlesnake ids are only used here, the simulator and AI identify snakes by their index
+        const std::string playerId = t_data["you"]["id"].s();
+        unsigned int playerIndex = Simulator::MAX_SNAKES;
+
+        std::vector<Simulator::Snake> snakes;
         auto snakesData = t_data["board"]["snakes"];
         for (const auto& snakeData : snakesData.lo()) {     
             const std::string id = snakeData["id"].s();
             const int health = snakeData["health"].i();
 
+            // Boards hold at most MAX_SNAKES snakes, any extra opponents are left out
+            const bool isPlayer = (id == playerId);
+            const unsigned int reserved = (playerIndex == Simulator::MAX_SNAKES) ? 1 : 0;
+            if (!isPlayer && snakes.size() + reserved >= Simulator::MAX_SNAKES) {
+                continue;
+            }
+            if (isPlayer) {
+                playerIndex = snakes.size();
+            }
+
             std::vector<Simulator::Position> body;
             body.reserve(snakeData["length"].u());
             auto bodyData = snakeData["body"];
@@ -29,14 +92,14 @@ namespace ServerLogic {
                 ); 
             }
 
-            snakes.emplace(id, Simulator::Snake(body, health));
+            snakes.emplace_back(body, health);
         }
 
         const unsigned int noSnakes = snakes.size();
         const unsigned int foodSpawnChance = t_data["game"]["ruleset"]["settings"]["foodSpawnChance"].u();
         const unsigned int minFood = t_data["game"]["ruleset"]["settings"]["minimumFood"].u();
-                
-        const Simulator::Ruleset ruleset{w, h, noSnakes, foodSpawnChance, minFood};
+
+        const Simulator::Ruleset ruleset = make_ruleset(w, h, noSnakes, minFood, foodSpawnChance);
 
         Grid<bool> food{w, h};
         const unsigned int foodCount = t_data["board"]["food"].size();
@@ -48,10 +111,109 @@ namespace ServerLogic {
         }
         
          const Simulator::Board board{snakes, Simulator::FoodGrid{food, foodCount}, ruleset};
-
-        const std::string id = t_data["you"]["id"].s();
         
-        return Simulator::direction_to_string(AI::seek_food_player(board, id));
+        // Seeded by turn so that seek_food always gives a request the same answer
+        AI::MCTSParameters params = AI::DEFAULT_PARAMETERS;
+        params.seed = t_data["turn"].u();
+
+        // A book move is only played if it is safe, in case of a hash collision
+        if (g_book.size() != 0) {
+            if (const std::optional<Simulator::Direction> move = g_book.find(AI::book_key(board, playerIndex))) {
+                const std::vector<Simulator::Direction> safeMoves = AI::get_safe_moves(board, playerIndex);
+                if (std::find(safeMoves.begin(), safeMoves.end(), *move) != safeMoves.end()) {
+                    return Simulator::direction_to_string(*move);
+                }
+            }
+        }
+
+        if (t_engine != AI::Engine::SUCT && t_engine != AI::Engine::TREE_SUCT) {
+            return Simulator::direction_to_string(AI::engine_player(t_engine, board, playerIndex, params));
+        }
+
+        // The tree is taken out of the map while searching so that the lock is not held
+        const std::string key = get_tree_key(t_data);
+        std::unique_ptr<GameSearch> game;
+        {
+            std::lock_guard<std::mutex> lock(g_treesMutex);
+            const auto it = g_trees.find(key);
+            if (it != g_trees.end()) {
+                game = std::move(it->second);
+                g_trees.erase(it);
+            }
+        }
+        if (!game) {
+            game = std::make_unique<GameSearch>();
+        }
+
+        // The search continues from the subtree of the moves that were played, grown while pondering.
+        // Tree parallel searches only reuse the memory of their shared tree.
+        game->stop_pondering();
+        const Simulator::Direction move = AI::engine_player(t_engine, board, playerIndex, params, &game->tree);
+
+        if (t_ponder && t_engine == AI::Engine::SUCT) {
+            AI::MCTSParameters ponderParams = params;
+            ponderParams.computeTime = MAX_PONDER_TIME;
+            GameSearch& pondered = *game;
+            game->ponderThread = std::thread([&pondered, move, ponderParams]() {
+                AI::mcts_suct_ponder(pondered.tree, move, ponderParams, pondered.stopPondering);
+            });
+        }
+
+        // Expired games stop pondering when they are freed, after the lock is released
+        std::vector<std::unique_ptr<GameSearch>> expired;
+        {
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            game->lastUsed = now;
+
+            std::lock_guard<std::mutex> lock(g_treesMutex);
+            take_expired_games(now, expired);
+            g_trees.insert_or_assign(key, std::move(game));
+        }
+
+        return Simulator::direction_to_string(move);
+    }
+
+    void end_game(const crow::json::rvalue& t_data) {
+        // Pondering is stopped once the lock is released, when game goes out of scope
+        std::unique_ptr<GameSearch> game;
+        std::lock_guard<std::mutex> lock(g_treesMutex);
+        const auto it = g_trees.find(get_tree_key(t_data));
+        if (it != g_trees.end()) {
+            game = std::move(it->second);
+            g_trees.erase(it);
+        }
+    }
+
+    Simulator::Ruleset make_ruleset(unsigned int t_w, unsigned int t_h, unsigned int t_noSnakes, unsigned int t_minFood, unsigned int t_foodSpawnChance) {
+        Simulator::Ruleset result = Simulator::DEFAULT_RULESET;
+        result.w = t_w;
+        result.h = t_h;
+        result.noSnakes = t_noSnakes;
+        result.minFood = t_minFood;
+        result.foodSpawnChance = t_foodSpawnChance;
+        return result;
+    }
+
+    bool load_book(const std::string& t_path) {
+        g_book = AI::OpeningBook(t_path);
+        return g_book.size() != 0;
+    }
+
+    void take_expired_games(std::chrono::steady_clock::time_point t_now, std::vector<std::unique_ptr<GameSearch>>& t_expired) {
+        for (auto it = g_trees.begin(); it != g_trees.end(); ) {
+            if (t_now - it->second->lastUsed > GAME_EXPIRY_TIME) {
+                t_expired.push_back(std::move(it->second));
+                it = g_trees.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    std::string get_tree_key(const crow::json::rvalue& t_data) {
+        // A server can play several snakes in the same game
+        return std::string(t_data["game"]["id"].s()) + '/' + std::string(t_data["you"]["id"].s());
     }
 
 }
@@ -5,9 +5,25 @@
 
 #include "crow/json.h"
 
+#include "ai.hpp"
+#include "simulator.hpp"
+
 namespace ServerLogic {
 
-    std::string choose_move(const crow::json::rvalue& t_data);
+    // Engines that keep a search tree between moves keep one per game and snake until end_game,
+    // or until the game goes a minute without a request.
+    // With t_ponder the tree is searched on a background thread from the reply
+    // until the next request of the game, see AI::mcts_suct_ponder.
+    std::string choose_move(const crow::json::rvalue& t_data, AI::Engine t_engine=AI::Engine::SEEK_FOOD, bool t_ponder=false);
+    void end_game(const crow::json::rvalue& t_data);
+
+    // Ruleset of a game from the settings of a request. Requests do not give
+    // the starting health, snakes start with and eat back to full health.
+    Simulator::Ruleset make_ruleset(unsigned int t_w, unsigned int t_h, unsigned int t_noSnakes, unsigned int t_minFood, unsigned int t_foodSpawnChance);
+
+    // Positions in the book are answered from it before any engine is asked.
+    // Must be called before the server starts, returns false if t_path is not a book.
+    bool load_book(const std::string& t_path);
 
 }
 
@@ -1,13 +1,10 @@
 #include <algorithm>
-#include <iostream>
-#include <random>
 
 #include "simulator.hpp"
+#include "zobrist.hpp"
 
 namespace Simulator {
 
-    static std::mt19937 rng(0);
-
     size_t PositionHash::operator()(const Position& t_pos) const noexcept {
         return std::hash<int>()(t_pos.x) ^ (std::hash<int>()(t_pos.y) << 1);
     }
@@ -20,11 +17,54 @@ namespace Simulator {
         return !(t_p1 == t_p2);
     }
 
+    Snake::const_iterator::const_iterator(const Snake* t_snake, unsigned int t_index)
+        : m_snake(t_snake)
+        , m_index(t_index)
+    {
+        ;
+    }
+
+    const Position& Snake::const_iterator::operator*() const {
+        return m_snake->m_body[(m_snake->m_tail + m_index) & (m_snake->m_body.size() - 1)];
+    }
+
+    const Position* Snake::const_iterator::operator->() const {
+        return &**this;
+    }
+
+    Snake::const_iterator& Snake::const_iterator::operator++() {
+        m_index++;
+        return *this;
+    }
+
+    Snake::const_iterator Snake::const_iterator::operator++(int) {
+        const const_iterator result = *this;
+        m_index++;
+        return result;
+    }
+
+    bool operator==(const Snake::const_iterator& t_it1, const Snake::const_iterator& t_it2) {
+        return (t_it1.m_snake == t_it2.m_snake) && (t_it1.m_index == t_it2.m_index);
+    }
+
+    bool operator!=(const Snake::const_iterator& t_it1, const Snake::const_iterator& t_it2) {
+        return !(t_it1 == t_it2);
+    }
+
     Snake::Snake(const std::vector<Position>& t_body, int t_health)
-        : m_body(t_body)
+        : m_body()
+        , m_tail(0)
+        , m_length(t_body.size())
         , m_health(t_health)
     {
-        ;
+        // Leave room for the head pushed by move before the tail is popped
+        unsigned int capacity = 1;
+        while (capacity < m_length + 1) {
+            capacity *= 2;
+        }
+
+        m_body.resize(capacity);
+        std::copy(t_body.begin(), t_body.end(), m_body.begin());
     }
 
     Snake::Snake(Position t_head, unsigned int t_length, int t_health) : Snake(std::vector<Position>(t_length, t_head), t_health) {
@@ -32,13 +72,20 @@ namespace Simulator {
     }
 
     void Snake::move(Direction t_direction) {
-        m_body.push_back(update_position(get_head(), t_direction));
+        if (m_length == m_body.size()) {
+            reserve(m_length + 1);
+        }
+
+        const Position head = update_position(get_head(), t_direction);
+        m_body[(m_tail + m_length) & (m_body.size() - 1)] = head;
+        m_length++;
         m_health--;
     }
 
     void Snake::pop_tail() {
-        if (m_body.size() > 1) {
-            m_body.erase(m_body.begin());
+        if (m_length > 1) {
+            m_tail = (m_tail + 1) & (m_body.size() - 1);
+            m_length--;
         }
     }
 
@@ -46,16 +93,48 @@ namespace Simulator {
         m_health = t_health;
     }
 
+    void Snake::reserve(unsigned int t_capacity) {
+        if (t_capacity <= m_body.size()) {
+            return;
+        }
+
+        unsigned int capacity = m_body.size();
+        while (capacity < t_capacity) {
+            capacity *= 2;
+        }
+
+        std::vector<Position> body(capacity);
+        std::copy(begin(), end(), body.begin());
+        m_body = std::move(body);
+        m_tail = 0;
+    }
+
     Position Snake::get_head() const {
-        return m_body[get_length() - 1];
+        return get_segment(m_length - 1);
+    }
+
+    Position Snake::get_tail() const {
+        return get_segment(0);
+    }
+
+    Position Snake::get_segment(unsigned int t_index) const {
+        return m_body[(m_tail + t_index) & (m_body.size() - 1)];
     }
 
-    const std::vector<Position>& Snake::get_body() const {
-        return m_body;
+    std::vector<Position> Snake::get_body() const {
+        return std::vector<Position>(begin(), end());
+    }
+
+    Snake::const_iterator Snake::begin() const {
+        return const_iterator(this, 0);
+    }
+
+    Snake::const_iterator Snake::end() const {
+        return const_iterator(this, m_length);
     }
 
     unsigned int Snake::get_length() const {
-        return m_body.size();
+        return m_length;
     }
 
     int Snake::get_health() const {
@@ -66,34 +145,112 @@ namespace Simulator {
         return m_health > 0;
     }
 
-    Board::Board(const std::unordered_map<std::string, Snake>& t_snakes, const FoodGrid& t_food, Ruleset t_ruleset)
+    SparseCellSet::SparseCellSet(unsigned int t_capacity)
+        : m_cells(t_capacity)
+        , m_positions(t_capacity, ABSENT)
+        , m_size(0)
+    {
+        ;
+    }
+
+    void SparseCellSet::insert(unsigned int t_cell) {
+        if (m_positions[t_cell] == ABSENT) {
+            m_positions[t_cell] = m_size;
+            m_cells[m_size++] = t_cell;
+        }
+    }
+
+    void SparseCellSet::erase(unsigned int t_cell) {
+        const unsigned int position = m_positions[t_cell];
+        if (position != ABSENT) {
+            // Fill the hole with the last member
+            const unsigned int last = m_cells[--m_size];
+            m_cells[position] = last;
+            m_positions[last] = position;
+            m_positions[t_cell] = ABSENT;
+        }
+    }
+
+    bool SparseCellSet::contains(unsigned int t_cell) const {
+        return m_positions[t_cell] != ABSENT;
+    }
+
+    unsigned int SparseCellSet::size() const {
+        return m_size;
+    }
+
+    unsigned int SparseCellSet::operator[](unsigned int t_index) const {
+        return m_cells[t_index];
+    }
+
+    Board::Board(const std::vector<Snake>& t_snakes, const FoodGrid& t_food, Ruleset t_ruleset, uint64_t t_seed)
         : m_snakes(t_snakes)
         , m_food(t_food)
         , m_ruleset(t_ruleset)
+        , m_rng(t_seed)
+        , m_tailTurns()
+        , m_occupancy(t_ruleset.w, t_ruleset.h)
+        , m_freeCells(t_ruleset.w * t_ruleset.h)
+        , m_turn(0)
+        , m_hash(0)
+        , m_alive((1u << t_snakes.size()) - 1)
     {
-        ;
+        place_snakes();
     }
 
-    Board::Board(const Board& t_board, Ruleset t_ruleset) 
-        : Board(t_board.get_snakes(), t_board.get_food(), t_ruleset) 
+    Board::Board(const Board& t_board, Ruleset t_ruleset)
+        : m_snakes(t_board.m_snakes)
+        , m_food(t_board.m_food)
+        , m_ruleset(t_ruleset)
+        , m_rng(t_board.m_rng)
+        , m_tailTurns()
+        , m_occupancy(t_ruleset.w, t_ruleset.h)
+        , m_freeCells(t_ruleset.w * t_ruleset.h)
+        , m_turn(0)
+        , m_hash(0)
+        , m_alive(t_board.m_alive)
     {
-        ;
+        place_snakes();
     }
 
-    void Board::update(const std::unordered_map<std::string, Direction>& t_moves) {
-        for (auto& [k, snake] : m_snakes) {
-            const auto moveIt = t_moves.find(k);
-            if (moveIt != t_moves.end()) {
-                snake.move(moveIt->second);
+    void Board::update(const MoveArray& t_moves) {
+        m_turn++;
+
+        std::array<Position, MAX_SNAKES> tails;
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (!is_alive(i)) continue;
+
+            Snake& snake = m_snakes[i];
+            tails[i] = snake.get_tail();
+
+            // The new head is only hashed once it is known to survive
+            const unsigned int head = to_cell(snake.get_head());
+            m_hash ^=
+                Zobrist::segment(head, i, SegmentRole::HEAD) ^
+                Zobrist::segment(head, i, direction_to_role(t_moves[i])) ^
+                Zobrist::length(i, snake.get_length()) ^ Zobrist::length(i, snake.get_length() + 1) ^
+                Zobrist::health(i, snake.get_health()) ^ Zobrist::health(i, snake.get_health() - 1);
+            snake.move(t_moves[i]);
+        }
+
+        feed_snakes();
+        const uint8_t eliminated = place_heads();
+
+        // Only tails can have been vacated and only heads newly covered
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (is_alive(i)) {
+                release_cell(tails[i]);
             }
-            else {
-                snake.move(Simulator::Direction::UP); // TODO: change this
+        }
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            const Position head = m_snakes[i].get_head();
+            if (is_alive(i) && is_in_bounds(head)) {
+                m_freeCells.erase(to_cell(head));
             }
         }
 
-        feed_snakes();
         spawn_food();
-        eliminate_snakes();
+        eliminate_snakes(eliminated);
     }
 
     Ruleset Board::get_ruleset() const {
@@ -106,81 +263,78 @@ namespace Simulator {
             (t_position.y >= 0 && t_position.y < m_ruleset.h);
     }
 
-    bool Board::is_safe_cell(const std::string& t_id, Position t_position) const {
-        if (!is_in_bounds(t_position)) {
+    bool Board::is_safe_cell(unsigned int t_index, Position t_position) const {
+        if (!is_in_bounds(t_position) || !is_alive(t_index)) {
             return false;
         }
 
-        const auto snakeIt = m_snakes.find(t_id);
-        if (snakeIt == m_snakes.end()) {
-            return false; // TODO: change this
+        const Occupant occupant = m_occupancy(t_position.x, t_position.y);
+        if (!is_occupied(occupant)) {
+            return true;
         }
 
-        const Snake& snake = snakeIt->second;
-
-        const auto& body = snake.get_body();
-        if (std::find(body.begin(), body.end() - 1, t_position) != body.end() - 1) {
+        // Anything older than a head is body
+        if (occupant.turn != m_turn) {
             return false;
         }
 
-        for (auto& [otherId, otherSnake] : m_snakes) {
-            if (t_id == otherId) continue;
-            
-            if (t_position == otherSnake.get_head() && snake.get_length() <= otherSnake.get_length()) {
-                return false;
-            }  
-                
-            const auto& otherBody = otherSnake.get_body();
-            if (std::find(otherBody.begin(), otherBody.end() - 1, t_position) != otherBody.end() - 1) {
-                return false;
-            }
+        const Snake& owner = m_snakes[occupant.owner];
+
+        // Every segment is stacked on the head, so the cell is body as well
+        if (owner.get_length() > 1 && owner.get_tail() == owner.get_head()) {
+            return false;
         }
 
-        return true;
+        return occupant.owner == t_index || m_snakes[t_index].get_length() > owner.get_length();
     }
 
-    const std::unordered_map<std::string, Snake>& Board::get_snakes() const {
-        return m_snakes;
+    unsigned int Board::get_snake_count() const {
+        return m_snakes.size();
     }
 
-    const Snake& Board::get_snake(const std::string& t_id) const {
-        const auto snakeIt = m_snakes.find(t_id);
-        if (snakeIt != m_snakes.end()) {
-            return snakeIt->second;
-        }
-        else {
-            std::cout << t_id << " oops\n";
-            return m_snakes.at(t_id);
-        }
+    bool Board::is_alive(unsigned int t_index) const {
+        return (m_alive >> t_index) & 1;
+    }
+
+    const Snake& Board::get_snake(unsigned int t_index) const {
+        return m_snakes[t_index];
     }
 
     const FoodGrid& Board::get_food() const {
         return m_food;
     }
 
-    const std::string* Board::get_winner() const {
-        switch (m_snakes.size()) {
-            case 1:
-                return &m_snakes.begin()->first;
-            default:
-                return nullptr;
+    const SparseCellSet& Board::get_free_cells() const {
+        return m_freeCells;
+    }
+
+    unsigned int Board::get_winner() const {
+        if (m_alive != 0 && (m_alive & (m_alive - 1)) == 0) {
+            for (unsigned int i = 0; i < m_snakes.size(); i++) {
+                if (is_alive(i)) {
+                    return i;
+                }
+            }
         }
+        return m_snakes.size();
     }
 
     bool Board::is_game_over() const {
-        return (m_snakes.size() <= 1);
+        return (m_alive & (m_alive - 1)) == 0;
     }
 
-    bool Board::is_valid_id(const std::string &t_id) const {
-        return m_snakes.count(t_id);
+    uint64_t Board::get_hash() const {
+        return m_hash;
     }
 
     std::string Board::to_string() const {
         std::string result;
 
         result += "DIM: " + std::to_string(m_ruleset.w) + 'x' + std::to_string(m_ruleset.h) + '\n';
-        for (const auto& [id, snake] : m_snakes) {
-            result += "Player " + id + " Health: " + std::to_string(snake.get_health()) + '\n';
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (is_alive(i)) {
+                result += "Player " + std::to_string(i) + " Health: " + std::to_string(m_snakes[i].get_health()) + '\n';
+            }
         }
 
         for (int x = 0; x < m_ruleset.w; x++) {
@@ -192,26 +346,18 @@ namespace Simulator {
             result += "# ";
 
             for (int x = 0; x < m_ruleset.w; x++) {
-                const Position pos{x, y};
-
-                bool snakeFound = false;
-                for (auto& [k, snake] : m_snakes) {
-                    const auto& body = snake.get_body();
-                    if (std::find(body.begin(), body.end(), pos) != body.end()) {
-                        if (pos == snake.get_head()) {
-                            result += "H";
-                        }
-                        else {
-                            const char c = k.back();
-                            result += ('A' <= c && c <= 'Z') ? (c + 0x20) : (c);
-                        }
-                        snakeFound = true;
-                        break;
+                const Occupant occupant = m_occupancy(x, y);
+
+                if (is_occupied(occupant)) {
+                    if (occupant.turn == m_turn) {
+                        result += "H";
+                    }
+                    else {
+                        result += static_cast<char>('a' + occupant.owner);
                     }
                 }
-
-                if (!snakeFound) {
-                    if (m_food.cells(x, y)) {
+                else {
+                    if (has_food(Position{x, y})) {
                         result += "*";
                     }
                     else {
@@ -234,57 +380,151 @@ namespace Simulator {
     }
 
 
+    bool Board::is_occupied(Occupant t_occupant) const {
+        return
+            (t_occupant.owner != Occupant::NO_OWNER) &&
+            (t_occupant.turn >= m_tailTurns[t_occupant.owner]);
+    }
+
+    bool Board::is_occupied(Position t_position) const {
+        return is_occupied(m_occupancy(t_position.x, t_position.y));
+    }
+
+    unsigned int Board::to_cell(Position t_position) const {
+        return t_position.y * m_ruleset.w + t_position.x;
+    }
+
+    void Board::place_snakes() {
+        m_tailTurns.assign(m_snakes.size(), NO_TURN);
+
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (!is_alive(i)) continue;
+
+            Snake& snake = m_snakes[i];
+
+            // A snake can never cover more than every cell, so bodies never need to grow during the game
+            snake.reserve(m_ruleset.w * m_ruleset.h + 1);
+
+            // Date the segments so that the head was placed this turn
+            int turn = m_turn - static_cast<int>(snake.get_length()) + 1;
+            m_tailTurns[i] = turn;
+            for (Position segment : snake) {
+                if (is_in_bounds(segment)) {
+                    m_occupancy(segment.x, segment.y) = Occupant{i, turn};
+                }
+                turn++;
+            }
+        }
+
+        for (int y = 0; y < m_ruleset.h; y++) {
+            for (int x = 0; x < m_ruleset.w; x++) {
+                release_cell(Position{x, y});
+            }
+        }
+
+        m_hash = compute_hash();
+    }
+
+    bool Board::has_food(Position t_position) const {
+        return static_cast<unsigned int>(t_position.x) < m_food.cells.get_width()
+            && static_cast<unsigned int>(t_position.y) < m_food.cells.get_height()
+            && m_food.cells(t_position.x, t_position.y);
+    }
+
+    void Board::release_cell(Position t_position) {
+        if (is_in_bounds(t_position) && !is_occupied(t_position) && !has_food(t_position)) {
+            m_freeCells.insert(to_cell(t_position));
+        }
+    }
+
+    uint64_t Board::hash_body(unsigned int t_index) const {
+        // Stacked segments are implied by the length
+        const Snake& snake = m_snakes[t_index];
+        uint64_t result = 0;
+        for (unsigned int j = 0; j + 1 < snake.get_length(); j++) {
+            const Position segment = snake.get_segment(j);
+            const Position next = snake.get_segment(j + 1);
+            if (segment != next) {
+                result ^= Zobrist::segment(to_cell(segment), t_index, direction_to_role(direction_to(segment, next)));
+            }
+        }
+        return result;
+    }
+
+    uint64_t Board::compute_hash() const {
+        uint64_t result = FoodGridHash{}(m_food);
+
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (!is_alive(i)) continue;
+
+            const Snake& snake = m_snakes[i];
+            result ^=
+                hash_body(i) ^
+                Zobrist::segment(to_cell(snake.get_head()), i, SegmentRole::HEAD) ^
+                Zobrist::length(i, snake.get_length()) ^
+                Zobrist::health(i, snake.get_health());
+        }
+
+        return result;
+    }
+
     void Board::feed_snakes() {
-        std::unordered_set<Position, PositionHash> eatenFood = {};
-        for (auto& [k, snake] : m_snakes) {
+        // Food is only removed once every snake has been checked so that snakes meeting head on over food both eat
+        uint8_t fed = 0;
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (!is_alive(i)) continue;
+
+            Snake& snake = m_snakes[i];
             const Position head = snake.get_head();
-            if (is_in_bounds(head) && m_food.cells(head.x, head.y)) {
+            if (is_in_bounds(head) && has_food(head)) {
+                m_hash ^= Zobrist::health(i, snake.get_health()) ^ Zobrist::health(i, m_ruleset.startingHealth);
                 snake.set_health(m_ruleset.startingHealth);
-                eatenFood.insert(head);
+                fed |= (1u << i);
             }
-            else {
+            else if (snake.get_length() > 1) {
+                const Position tail = snake.get_tail();
+                const Position next = snake.get_segment(1);
+                if (tail != next) {
+                    m_hash ^= Zobrist::segment(to_cell(tail), i, direction_to_role(direction_to(tail, next)));
+                }
+                m_hash ^= Zobrist::length(i, snake.get_length()) ^ Zobrist::length(i, snake.get_length() - 1);
                 snake.pop_tail();
             }
         }
 
-        for (Position food : eatenFood) {
-            m_food.cells(food.x, food.y) = false;
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (!((fed >> i) & 1)) continue;
+
+            const Position food = m_snakes[i].get_head();
+            if (has_food(food)) {
+                m_food.cells(food.x, food.y) = false;
+                m_food.count--;
+                m_hash ^= Zobrist::food(to_cell(food));
+            }
         }
-        m_food.count -= eatenFood.size();
     }
 
     void Board::randomly_place_food(unsigned int t_count) {
-        std::vector<Position> freeCells;
-        freeCells.reserve(m_food.cells.size());
-        
-        for (int y = 0; y < m_food.cells.get_height(); y++) {
-            for (int x = 0; x < m_food.cells.get_width(); x++) {
-                const Position pos = {x, y};
-                if (
-                    !m_food.cells(x, y) && 
-                    std::none_of(
-                        m_snakes.begin(),
-                        m_snakes.end(),
-                        [pos](const auto& keyValue) -> bool {
-                            const auto& body = keyValue.second.get_body();
-                            return std::find(body.begin(), body.end(), pos) != body.end();
-                        }
-                    )
-                ) {
-                    freeCells.push_back(pos);
+        const unsigned int foodToAdd = std::min(m_freeCells.size(), t_count);
+
+        // Free cells cover the whole board, so a smaller food grid is grown to the board first
+        if (foodToAdd != 0 && (m_food.cells.get_width() < m_ruleset.w || m_food.cells.get_height() < m_ruleset.h)) {
+            Grid<bool> cells(m_ruleset.w, m_ruleset.h);
+            for (unsigned int y = 0; y < m_ruleset.h; y++) {
+                for (unsigned int x = 0; x < m_ruleset.w; x++) {
+                    cells(x, y) = has_food(Position{static_cast<int>(x), static_cast<int>(y)});
                 }
             }
+            m_food.cells = std::move(cells);
         }
 
-        std::shuffle(freeCells.begin(), freeCells.end(), rng);
-
-        const unsigned int foodToAdd = std::min(freeCells.size(), static_cast<size_t>(t_count));
         for (unsigned int i = 0; i < foodToAdd; i++) {
-            const Position pos = freeCells[i];
-            m_food.cells(pos.x, pos.y) = true;
+            const unsigned int cell = m_freeCells[m_rng.below(m_freeCells.size())];
+            m_freeCells.erase(cell);
+            m_food.cells(cell % m_ruleset.w, cell / m_ruleset.w) = true;
+            m_hash ^= Zobrist::food(cell);
         }
         m_food.count += foodToAdd;
-
     }
 
     void Board::spawn_food() {
@@ -292,33 +532,91 @@ namespace Simulator {
             if (m_food.count < m_ruleset.minFood) {
                 randomly_place_food(m_ruleset.minFood - m_food.count);
             }
-            else if (rng() % 100 < m_ruleset.foodSpawnChance) {
+            else if (m_rng.below(100) < m_ruleset.foodSpawnChance) {
                 randomly_place_food(1);
             }
         }
     }
 
-    void Board::eliminate_snakes() {
-        std::vector<std::string> toBeEliminated;
-        for (const auto& [id, snake] : m_snakes) {
-            if (!snake.is_alive() || !is_safe_cell(id, snake.get_head())) {
-                toBeEliminated.push_back(id);
+    uint8_t Board::place_heads() {
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (is_alive(i)) {
+                m_tailTurns[i] = m_turn - static_cast<int>(m_snakes[i].get_length()) + 1;
+            }
+        }
+
+        // Heads are placed one at a time. A cell holding a segment from an
+        // earlier turn is body, while one holding a segment from this turn is
+        // another head, which only the strictly longest snake survives.
+        uint8_t eliminated = 0;
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (!is_alive(i)) continue;
+
+            const Snake& snake = m_snakes[i];
+            const Position head = snake.get_head();
+
+            if (!snake.is_alive()) {
+                eliminated |= (1u << i);
+            }
+
+            if (!is_in_bounds(head)) {
+                eliminated |= (1u << i);
+                continue;
+            }
+
+            Occupant& occupant = m_occupancy(head.x, head.y);
+            if (!is_occupied(occupant)) {
+                occupant = Occupant{i, m_turn};
+            }
+            else if (occupant.turn != m_turn) {
+                eliminated |= (1u << i);
+            }
+            else {
+                const unsigned int other = occupant.owner;
+                if (snake.get_length() <= m_snakes[other].get_length()) {
+                    eliminated |= (1u << i);
+                }
+                if (m_snakes[other].get_length() <= snake.get_length()) {
+                    eliminated |= (1u << other);
+                    occupant = Occupant{i, m_turn};
+                }
+            }
+        }
+
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (is_alive(i) && !((eliminated >> i) & 1)) {
+                m_hash ^= Zobrist::segment(to_cell(m_snakes[i].get_head()), i, SegmentRole::HEAD);
             }
         }
-        for (const auto& id : toBeEliminated) {
-            m_snakes.erase(id);
+        return eliminated;
+    }
+
+    void Board::eliminate_snakes(uint8_t t_eliminated) {
+        for (unsigned int i = 0; i < m_snakes.size(); i++) {
+            if (!((t_eliminated >> i) & 1)) continue;
+
+            const Snake& snake = m_snakes[i];
+            m_hash ^= hash_body(i) ^ Zobrist::length(i, snake.get_length()) ^ Zobrist::health(i, snake.get_health());
+
+            m_tailTurns[i] = NO_TURN;
+            m_alive &= ~(1u << i);
+
+            for (Position segment : snake) {
+                release_cell(segment);
+            }
         }
     }
 
     bool operator==(const Snake& t_s1, const Snake& t_s2) {
         return
             (t_s1.m_health == t_s2.m_health) &&
-            (t_s1.m_body == t_s2.m_body);
+            (t_s1.m_length == t_s2.m_length) &&
+            std::equal(t_s1.begin(), t_s1.end(), t_s2.begin());
     }
 
     size_t SnakeHash::operator()(const Snake& t_snake) const noexcept {
         size_t result = std::hash<int>()(t_snake.m_health);
-        for (Position pos : t_snake.m_body) {
+        for (Position pos : t_snake) {
             result = (result ^ (PositionHash{}(pos) << 1)) >> 1;
         }
         return result;
@@ -343,9 +641,10 @@ namespace Simulator {
 
     size_t FoodGridHash::operator()(const FoodGrid& t_foodGrid) const noexcept {
         size_t result = 0;
+        const unsigned int w = t_foodGrid.cells.get_width();
         for (unsigned int y = 0; y < t_foodGrid.cells.get_height(); y++) {
-            for (unsigned int x = 0; x < t_foodGrid.cells.get_width(); x++) {
-                result = (result ^ (std::hash<bool>()(t_foodGrid.cells(x, y)) << 1)) >> 1;
+            for (uint64_t row = t_foodGrid.cells.get_row(y); row != 0; row &= row - 1) {
+                result ^= Zobrist::food(y * w + __builtin_ctzll(row));
             }
         }
 
@@ -353,27 +652,28 @@ namespace Simulator {
     }
 
     bool operator==(const Board& t_b1, const Board& t_b2) {
-        return
+        if (!(
             (t_b1.m_ruleset == t_b2.m_ruleset) &&
-            (t_b1.m_snakes == t_b2.m_snakes) &&
-            (t_b1.m_food == t_b2.m_food);
+            (t_b1.m_snakes.size() == t_b2.m_snakes.size()) &&
+            (t_b1.m_alive == t_b2.m_alive) &&
+            (t_b1.m_food == t_b2.m_food)
+        )) {
+            return false;
+        }
+
+        // Eliminated snakes are no longer part of the game
+        for (unsigned int i = 0; i < t_b1.m_snakes.size(); i++) {
+            if (t_b1.is_alive(i) && !(t_b1.m_snakes[i] == t_b2.m_snakes[i])) {
+                return false;
+            }
+        }
+
+        return true;
     }
 
     size_t BoardHash::operator()(const Board& t_board) const noexcept {
-        // return 0;
-
-        ///*
         // ruleset not included in hash as it does not change during the course of a game
-        size_t result = FoodGridHash{}(t_board.m_food);
-        for (const auto& [id, snake] : t_board.m_snakes) {
-            // id not included since it also does not change
-            const size_t snakeHash = SnakeHash{}(snake);
-
-            result = (result ^ (snakeHash << 1)) >> 1;
-        }
-
-        return result;
-        //*/
+        return t_board.m_hash;
     }
 
 }
@@ -1,18 +1,27 @@
 #ifndef SIMULATOR_INCLUDED
 #define SIMULATOR_INCLUDED
 
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <string>
-#include <unordered_set>
-#include <unordered_map>
 #include <vector>
 
 #include "crow/json.h"
 
 #include "grid.hpp"
+#include "rng.hpp"
 
 namespace Simulator {
 
+    // Capacity of the fixed size structures used by the search
+    constexpr unsigned int MAX_SNAKES = 8;
+    constexpr unsigned int MAX_BOARD_WIDTH = 19;
+    constexpr unsigned int MAX_BOARD_HEIGHT = 19;
+    constexpr unsigned int MAX_BOARD_CELLS = MAX_BOARD_WIDTH * MAX_BOARD_HEIGHT;
+
     enum class Direction {
         UP,
         DOWN,
@@ -57,8 +66,39 @@ namespace Simulator {
         }
     }
 
+    // Direction of the step from t_from to the adjacent position t_to
+    constexpr Direction direction_to(Position t_from, Position t_to) {
+        if (t_to.x == t_from.x) {
+            return (t_to.y < t_from.y) ? Direction::UP : Direction::DOWN;
+        }
+        return (t_to.x < t_from.x) ? Direction::LEFT : Direction::RIGHT;
+    }
+
     class Snake {
     public:
+        // Iterates over the body from the tail to the head
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Position;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Position*;
+            using reference = const Position&;
+
+            const_iterator(const Snake* t_snake, unsigned int t_index);
+
+            reference operator*() const;
+            pointer operator->() const;
+            const_iterator& operator++();
+            const_iterator operator++(int);
+
+            friend bool operator==(const const_iterator& t_it1, const const_iterator& t_it2);
+            friend bool operator!=(const const_iterator& t_it1, const const_iterator& t_it2);
+        private:
+            const Snake* m_snake;
+            unsigned int m_index;
+        };
+
         explicit Snake(const std::vector<Position>& t_body, int t_health=100);
         Snake(Position t_head, unsigned int t_length, int t_health=100);
 
@@ -70,8 +110,20 @@ namespace Simulator {
 
         void set_health(int t_health);
 
+        // Ensures the body can grow to t_capacity segments without reallocating
+        void reserve(unsigned int t_capacity);
+
         [[nodiscard]] Position get_head() const;
-        [[nodiscard]] const std::vector<Position>& get_body() const;
+        [[nodiscard]] Position get_tail() const;
+
+        // Returns the segment t_index places from the tail
+        [[nodiscard]] Position get_segment(unsigned int t_index) const;
+
+        // Returns a copy of the body ordered from the tail to the head, prefer iterating over the snake
+        [[nodiscard]] std::vector<Position> get_body() const;
+
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator end() const;
 
         [[nodiscard]] unsigned int get_length() const;
         [[nodiscard]] int get_health() const;
@@ -81,7 +133,11 @@ namespace Simulator {
         friend bool operator==(const Snake& t_s1, const Snake& t_s2);
         friend struct SnakeHash;
     private:
+        // The body is a circular buffer whose size is a power of two, so
+        // segment i from the tail lives at (m_tail + i) & (m_body.size() - 1)
         std::vector<Position> m_body;
+        unsigned int m_tail;
+        unsigned int m_length;
         int m_health;
     };
 
@@ -111,45 +167,125 @@ namespace Simulator {
         size_t operator()(const FoodGrid& t_foodGrid) const noexcept;
     };
 
+    // Moves for every snake on a board, indexed by snake
+    using MoveArray = std::array<Direction, MAX_SNAKES>;
+
+    // Set of cell indices in [0, capacity) with O(1) insertion, removal and
+    // access by position, so a random member can be drawn without scanning
+    // the board. Storage is only allocated by the constructor.
+    class SparseCellSet {
+    public:
+        explicit SparseCellSet(unsigned int t_capacity=0);
+
+        // Inserting a member or erasing a non member does nothing
+        void insert(unsigned int t_cell);
+        void erase(unsigned int t_cell);
+
+        [[nodiscard]] bool contains(unsigned int t_cell) const;
+        [[nodiscard]] unsigned int size() const;
+
+        // Members are kept in no particular order, t_index must be less than size()
+        [[nodiscard]] unsigned int operator[](unsigned int t_index) const;
+    private:
+        static constexpr unsigned int ABSENT = std::numeric_limits<unsigned int>::max();
+
+        std::vector<unsigned int> m_cells; // The first m_size entries are the members
+        std::vector<unsigned int> m_positions; // Position of each cell in m_cells, ABSENT if not a member
+        unsigned int m_size;
+    };
+
     class Board {
     public:
-        Board(const std::unordered_map<std::string, Snake>& t_snakes, const FoodGrid& t_food, Ruleset t_ruleset=DEFAULT_RULESET);
-        Board(const Board& t_board, Ruleset t_ruleset=DEFAULT_RULESET);
+        // Snake i is identified by the index i for the rest of the game, at most MAX_SNAKES snakes are supported
+        // t_seed seeds the generator used to spawn food, so equal seeds replay equal games
+        Board(const std::vector<Snake>& t_snakes, const FoodGrid& t_food, Ruleset t_ruleset=DEFAULT_RULESET, uint64_t t_seed=0);
+        // Copy of t_board played under a different ruleset, the copy continues the random sequence of t_board
+        Board(const Board& t_board, Ruleset t_ruleset);
 
-        void update(const std::unordered_map<std::string, Direction>& t_moves);
+        // Moves are indexed by snake, entries for eliminated snakes are ignored
+        void update(const MoveArray& t_moves);
 
         [[nodiscard]] Ruleset get_ruleset() const;
         [[nodiscard]] bool is_in_bounds(Position t_position) const;
-        [[nodiscard]] bool is_safe_cell(const std::string& t_id, Position t_position) const;
+        [[nodiscard]] bool is_safe_cell(unsigned int t_index, Position t_position) const;
 
-        [[nodiscard]] const std::unordered_map<std::string, Snake>& get_snakes() const;
-        [[nodiscard]] const Snake& get_snake(const std::string& t_id) const;
+        // Number of snakes the board was created with, including eliminated ones
+        [[nodiscard]] unsigned int get_snake_count() const;
+        [[nodiscard]] bool is_alive(unsigned int t_index) const;
+
+        // Eliminated snakes keep the body they were eliminated with
+        [[nodiscard]] const Snake& get_snake(unsigned int t_index) const;
         [[nodiscard]] const FoodGrid& get_food() const;
+        // The food grid may be smaller than the board, cells outside it have no food
+        [[nodiscard]] bool has_food(Position t_position) const;
+        // Cells holding neither food nor a snake, indexed y * w + x
+        [[nodiscard]] const SparseCellSet& get_free_cells() const;
 
         // Returns the index of the snake that has won the game
-        // If all snakes have been eliminated then m_snakes.size() is returned
-        [[nodiscard]] const std::string* get_winner() const;
+        // If there is no winner then get_snake_count() is returned
+        [[nodiscard]] unsigned int get_winner() const;
         [[nodiscard]] bool is_game_over() const;
-        [[nodiscard]] bool is_valid_id(const std::string& t_id) const;
+
+        // Zobrist hash of the board, kept up to date by update
+        [[nodiscard]] uint64_t get_hash() const;
 
         [[nodiscard]] std::string to_string() const;
 
         friend bool operator==(const Board& t_b1, const Board& t_b2);
         friend struct BoardHash;
     private:
+        static constexpr int NO_TURN = std::numeric_limits<int>::max();
+
+        // Newest snake segment placed on a cell. The segment is still part of
+        // its snake while its age, m_turn - turn, is less than the snake's
+        // length, so retracting a tail never has to touch the grid.
+        struct Occupant {
+            static constexpr unsigned int NO_OWNER = std::numeric_limits<unsigned int>::max();
+
+            unsigned int owner = NO_OWNER; // Index into m_snakes
+            int turn = 0;
+        };
+
+        [[nodiscard]] bool is_occupied(Occupant t_occupant) const;
+        [[nodiscard]] bool is_occupied(Position t_position) const;
+
+        [[nodiscard]] unsigned int to_cell(Position t_position) const;
+
+        // Writes the living snakes into the occupancy grid, then builds the free cells and the hash from scratch
+        void place_snakes();
+
+        // Adds t_position to the free cells if nothing is left on it
+        void release_cell(Position t_position);
+
+        // Hash of every segment but the head, which is hashed separately as it may be out of bounds
+        [[nodiscard]] uint64_t hash_body(unsigned int t_index) const;
+        [[nodiscard]] uint64_t compute_hash() const;
+
         void feed_snakes();
         void randomly_place_food(unsigned int t_count);
         void spawn_food();
-        void eliminate_snakes();
 
-        std::unordered_map<std::string, Snake> m_snakes;
+        // Writes the new heads into the occupancy grid and returns the snakes that must be eliminated as a bit mask
+        uint8_t place_heads();
+        void eliminate_snakes(uint8_t t_eliminated);
+
+        std::vector<Snake> m_snakes;
         FoodGrid m_food;
 
         Ruleset m_ruleset;
+        Rng m_rng;
+
+        std::vector<int> m_tailTurns; // Turn the tail segment of each snake was placed, NO_TURN once eliminated
+        Grid<Occupant> m_occupancy;
+        SparseCellSet m_freeCells;
+        int m_turn;
+
+        uint64_t m_hash;
+        uint8_t m_alive; // Bit i set if snake i is still in the game
     };
 
     struct BoardHash {
-        size_t operator()(const Board& t_ruleset) const noexcept;
+        size_t operator()(const Board& t_board) const noexcept;
     };
 
 }
@@ -0,0 +1,30 @@
+#include <algorithm>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../ai.hpp"
+
+TEST_CASE("alpha_beta_player searches boards with every snake slot used") {
+    // 7 opponents with 4 moves each make 4^7 joint replies at the first turn
+    std::vector<Simulator::Snake> snakes;
+    for (unsigned int i = 0; i < Simulator::MAX_SNAKES; i++) {
+        snakes.emplace_back(Simulator::Position{2 + 2 * static_cast<int>(i), 9}, 1);
+    }
+
+    Simulator::Ruleset ruleset = Simulator::DEFAULT_RULESET;
+    ruleset.w = 19;
+    ruleset.h = 19;
+    ruleset.noSnakes = Simulator::MAX_SNAKES;
+    const Simulator::Board board{snakes, Simulator::FoodGrid{Grid<bool>(19, 19), 0}, ruleset};
+
+    AI::MCTSParameters params = AI::DEFAULT_PARAMETERS;
+    params.computeTime = 100;
+    params.tableMegabytes = 1;
+    AI::SearchStats stats{};
+    const Simulator::Direction move = AI::alpha_beta_player(board, 0, params, &stats);
+
+    const std::vector<Simulator::Direction> safeMoves = AI::get_safe_moves(board, 0);
+    REQUIRE(std::find(safeMoves.begin(), safeMoves.end(), move) != safeMoves.end());
+    REQUIRE(stats.nodes > 0);
+}
@@ -0,0 +1,705 @@
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../bitboard.hpp"
+
+namespace {
+
+    void require_equivalent(const Simulator::Board& t_board, const Simulator::BitBoard& t_bitBoard) {
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+
+        REQUIRE(t_bitBoard.get_snake_count() == t_board.get_snake_count());
+        REQUIRE(t_bitBoard.is_game_over() == t_board.is_game_over());
+        REQUIRE(t_bitBoard.get_food_count() == t_board.get_food().count);
+        REQUIRE(t_bitBoard.get_winner() == t_board.get_winner());
+
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            REQUIRE(t_bitBoard.is_alive(i) == t_board.is_alive(i));
+            if (!t_bitBoard.is_alive(i)) continue;
+
+            const Simulator::Snake& snake = t_board.get_snake(i);
+            REQUIRE(t_bitBoard.get_head(i) == snake.get_head());
+            REQUIRE(t_bitBoard.get_length(i) == snake.get_length());
+            REQUIRE(t_bitBoard.get_health(i) == snake.get_health());
+
+            for (int y = -1; y <= static_cast<int>(ruleset.h); y++) {
+                for (int x = -1; x <= static_cast<int>(ruleset.w); x++) {
+                    const Simulator::Position pos{x, y};
+                    REQUIRE(t_bitBoard.is_safe_cell(i, pos) == t_board.is_safe_cell(i, pos));
+                }
+            }
+        }
+    }
+
+    // t_board turned by t_symmetry, every snake must be alive
+    Simulator::Board transform_board(const Simulator::Board& t_board, unsigned int t_symmetry) {
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        const bool transposed = (t_symmetry & 4) != 0;
+
+        Simulator::Ruleset transformedRuleset = ruleset;
+        if (transposed) {
+            std::swap(transformedRuleset.w, transformedRuleset.h);
+        }
+
+        std::vector<Simulator::Snake> snakes;
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            const Simulator::Snake& snake = t_board.get_snake(i);
+            std::vector<Simulator::Position> body = snake.get_body();
+            for (Simulator::Position& segment : body) {
+                segment = Simulator::transform_position(t_symmetry, segment, ruleset.w, ruleset.h);
+            }
+            snakes.emplace_back(body, snake.get_health());
+        }
+
+        Grid<bool> food(transformedRuleset.w, transformedRuleset.h);
+        for (unsigned int y = 0; y < ruleset.h; y++) {
+            for (unsigned int x = 0; x < ruleset.w; x++) {
+                if (t_board.get_food().cells(x, y)) {
+                    const Simulator::Position image = Simulator::transform_position(t_symmetry, {static_cast<int>(x), static_cast<int>(y)}, ruleset.w, ruleset.h);
+                    food(image.x, image.y) = true;
+                }
+            }
+        }
+
+        return Simulator::Board{snakes, Simulator::FoodGrid{food, t_board.get_food().count}, transformedRuleset};
+    }
+
+    // Territory worked out cell by cell. A cell holding segment j from the
+    // tail opens on turn j + 1, areas grow from the cells gained on the turn before.
+    Simulator::Territory reference_territory(const Simulator::Board& t_board) {
+        const Simulator::Ruleset ruleset = t_board.get_ruleset();
+        const unsigned int cellCount = ruleset.w * ruleset.h;
+        const auto to_cell = [&](Simulator::Position t_position) {
+            return static_cast<unsigned int>(t_position.y) * ruleset.w + static_cast<unsigned int>(t_position.x);
+        };
+
+        constexpr unsigned int UNREACHED = std::numeric_limits<unsigned int>::max();
+
+        std::vector<unsigned int> opensOn(cellCount, 0);
+        // Turn each cell was entered on, per snake
+        std::vector<std::vector<unsigned int>> owned(t_board.get_snake_count(), std::vector<unsigned int>(cellCount, UNREACHED));
+        std::vector<std::vector<unsigned int>> reachable = owned;
+        std::vector<bool> claimed(cellCount, false);
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            if (!t_board.is_alive(i)) continue;
+
+            const Simulator::Snake& snake = t_board.get_snake(i);
+            for (unsigned int j = 0; j < snake.get_length(); j++) {
+                opensOn[to_cell(snake.get_segment(j))] = j + 1;
+            }
+
+            const unsigned int head = to_cell(snake.get_head());
+            owned[i][head] = 0;
+            reachable[i][head] = 0;
+            claimed[head] = true;
+        }
+
+        const auto entered_next_to = [&](const std::vector<unsigned int>& t_entered, unsigned int t_cell, unsigned int t_turn) {
+            const Simulator::Position position{static_cast<int>(t_cell % ruleset.w), static_cast<int>(t_cell / ruleset.w)};
+            for (Simulator::Direction move : {Simulator::Direction::UP, Simulator::Direction::DOWN, Simulator::Direction::LEFT, Simulator::Direction::RIGHT}) {
+                const Simulator::Position next = Simulator::update_position(position, move);
+                if (t_board.is_in_bounds(next) && t_entered[to_cell(next)] == t_turn) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (unsigned int turn = 1; ; turn++) {
+            bool growing = false;
+            std::vector<unsigned int> enteredBy(cellCount, 0);
+            for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+                if (!t_board.is_alive(i)) continue;
+
+                const std::vector<unsigned int> before = reachable[i];
+                for (unsigned int cell = 0; cell < cellCount; cell++) {
+                    if (opensOn[cell] > turn) continue;
+
+                    if (before[cell] == UNREACHED && entered_next_to(before, cell, turn - 1)) {
+                        reachable[i][cell] = turn;
+                        growing = true;
+                    }
+                    if (!claimed[cell] && entered_next_to(owned[i], cell, turn - 1)) {
+                        enteredBy[cell] |= (1u << i);
+                        growing = true;
+                    }
+                }
+            }
+
+            if (!growing) break;
+
+            for (unsigned int cell = 0; cell < cellCount; cell++) {
+                if (enteredBy[cell] == 0) continue;
+
+                claimed[cell] = true;
+                if ((enteredBy[cell] & (enteredBy[cell] - 1)) == 0) {
+                    owned[__builtin_ctz(enteredBy[cell])][cell] = turn;
+                }
+            }
+        }
+
+        Simulator::Territory result{};
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            result.reachable[i] = static_cast<uint16_t>(cellCount - std::count(reachable[i].begin(), reachable[i].end(), UNREACHED));
+            result.owned[i] = static_cast<uint16_t>(cellCount - std::count(owned[i].begin(), owned[i].end(), UNREACHED));
+        }
+        return result;
+    }
+
+}
+
+TEST_CASE("BitBoard is trivially copyable") {
+    REQUIRE(std::is_trivially_copyable_v<Simulator::BitBoard>);
+    REQUIRE(sizeof(Simulator::BitBoard) < 512);
+}
+
+TEST_CASE("CellSet count and select correct") {
+    Simulator::CellSet set;
+    for (unsigned int cell : {2u, 63u, 64u, 200u, 360u}) {
+        set.set(cell);
+    }
+
+    REQUIRE(set.count() == 5);
+    REQUIRE(set.select(0) == 2);
+    REQUIRE(set.select(1) == 63);
+    REQUIRE(set.select(2) == 64);
+    REQUIRE(set.select(3) == 200);
+    REQUIRE(set.select(4) == 360);
+}
+
+TEST_CASE("BitBoard constructor correct") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({{1, 9}, {1, 8}, {2, 8}}, 50),
+        Simulator::Snake({{9, 3}, {9, 3}, {9, 2}, {9, 1}}, 70),
+    };
+
+    Grid<bool> foodGrid(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h);
+    foodGrid(5, 5) = true;
+    foodGrid(3, 7) = true;
+
+    const Simulator::Board board(snakes, Simulator::FoodGrid{foodGrid, 2}, Simulator::DEFAULT_RULESET);
+    const Simulator::BitBoard bitBoard(board);
+
+    REQUIRE(bitBoard.get_ruleset() == Simulator::DEFAULT_RULESET);
+    REQUIRE(bitBoard.get_snake_count() == 3);
+    REQUIRE(bitBoard.has_food({5, 5}) == true);
+    REQUIRE(bitBoard.has_food({3, 7}) == true);
+    REQUIRE(bitBoard.has_food({7, 3}) == false);
+    REQUIRE(bitBoard.has_food({-1, 3}) == false);
+
+    require_equivalent(board, bitBoard);
+}
+
+TEST_CASE("BitBoard operator== correct") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 9}, 3),
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
+    const Simulator::Board board(snakes, food, Simulator::DEFAULT_RULESET);
+    const Simulator::Board swapped({snakes[1], snakes[0]}, food, Simulator::DEFAULT_RULESET);
+
+    const Simulator::BitBoard b1(board);
+    const Simulator::BitBoard b2(board);
+    const Simulator::BitBoard b3(swapped);
+
+    Simulator::BitBoard b4 = b1;
+    b4.update({Simulator::Direction::DOWN, Simulator::Direction::UP});
+
+    REQUIRE(b1 == b2);
+    REQUIRE(Simulator::BitBoardHash{}(b1) == Simulator::BitBoardHash{}(b2));
+    REQUIRE(!(b1 == b3));
+    REQUIRE(!(b1 == b4));
+}
+
+TEST_CASE("BitBoard update matches Board") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 9}, 3),
+        Simulator::Snake({9, 1}, 3),
+        Simulator::Snake({9, 9}, 3),
+    };
+
+    const Simulator::MoveArray m1 {
+        Simulator::Direction::UP,
+        Simulator::Direction::UP,
+        Simulator::Direction::UP,
+        Simulator::Direction::UP,
+    };
+
+    const Simulator::MoveArray m2 {
+        Simulator::Direction::LEFT,
+        Simulator::Direction::LEFT,
+        Simulator::Direction::LEFT,
+        Simulator::Direction::LEFT,
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
+
+    // Food spawning is random, so disable it to compare the boards exactly
+    Simulator::Ruleset ruleset = Simulator::DEFAULT_RULESET;
+    ruleset.spawnFood = false;
+
+    Simulator::Board board(snakes, food, ruleset);
+    Simulator::BitBoard bitBoard(board);
+
+    for (const auto* moves : {&m1, &m1, &m2, &m2}) {
+        board.update(*moves);
+        bitBoard.update(*moves);
+        require_equivalent(board, bitBoard);
+    }
+
+    REQUIRE(bitBoard.is_game_over() == true);
+    REQUIRE(bitBoard.get_winner() == 3);
+}
+
+TEST_CASE("BitBoard update head on collision correct") {
+    const Simulator::MoveArray moves {
+        Simulator::Direction::RIGHT,
+        Simulator::Direction::LEFT,
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
+
+    for (const auto& [lengthA, lengthB] : {std::pair{3u, 3u}, std::pair{4u, 3u}, std::pair{3u, 4u}}) {
+        const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({0, 0}, lengthA),
+            Simulator::Snake({2, 0}, lengthB),
+        };
+
+        Simulator::Ruleset ruleset = Simulator::DEFAULT_RULESET;
+        ruleset.spawnFood = false;
+
+        Simulator::Board board(snakes, food, ruleset);
+        Simulator::BitBoard bitBoard(board);
+
+        board.update(moves);
+        bitBoard.update(moves);
+        require_equivalent(board, bitBoard);
+    }
+}
+
+TEST_CASE("BitBoard update consume food correct") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 9}, 3),
+        Simulator::Snake({2, 9}, 3),
+    };
+
+    Grid<bool> foodGrid(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h);
+    foodGrid(1, 8) = true;
+
+    const Simulator::Ruleset ruleset{10, 10, static_cast<unsigned int>(snakes.size()), 1, 15, 100, false};
+
+    Simulator::Board board(snakes, Simulator::FoodGrid{foodGrid, 1}, ruleset);
+    Simulator::BitBoard bitBoard(board);
+
+    bitBoard.update({Simulator::Direction::UP, Simulator::Direction::UP});
+    REQUIRE(bitBoard.get_health(0) == 100);
+    REQUIRE(bitBoard.get_length(0) == 4);
+    REQUIRE(bitBoard.get_health(1) == 99);
+    REQUIRE(bitBoard.get_length(1) == 3);
+    REQUIRE(bitBoard.has_food({1, 8}) == false);
+    REQUIRE(bitBoard.get_food_count() == 0);
+}
+
+TEST_CASE("BitBoard update spawn food correct") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 9}, 3),
+        Simulator::Snake({2, 9}, 3),
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
+
+    const Simulator::Ruleset r1{10, 10, static_cast<unsigned int>(snakes.size()), 10, 15, 100, false};
+    const Simulator::Ruleset r2{10, 10, static_cast<unsigned int>(snakes.size()), 10, 15, 100, true};
+
+    Simulator::BitBoard b1(Simulator::Board(snakes, food, r1));
+    Simulator::BitBoard b2(Simulator::Board(snakes, food, r2));
+
+    b1.update({Simulator::Direction::UP, Simulator::Direction::UP});
+    b2.update({Simulator::Direction::UP, Simulator::Direction::UP});
+    REQUIRE(b1.get_food_count() == 0);
+    REQUIRE(b2.get_food_count() == 10);
+
+    for (unsigned int i = 0; i < 2; i++) {
+        REQUIRE(b2.has_food(b2.get_head(i)) == false);
+    }
+}
+
+TEST_CASE("BitBoard spawn food reproducible from seed") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 9}, 3),
+        Simulator::Snake({2, 9}, 3),
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(10, 10), 0};
+    const Simulator::Ruleset ruleset{10, 10, static_cast<unsigned int>(snakes.size()), 5, 50, 100, true};
+    const Simulator::Board board(snakes, food, ruleset);
+
+    Simulator::BitBoard b1(board, 42);
+    Simulator::BitBoard b2(board, 42);
+    Simulator::BitBoard b3(board, 43);
+
+    for (unsigned int i = 0; i < 4; i++) {
+        b1.update({Simulator::Direction::UP, Simulator::Direction::UP});
+        b2.update({Simulator::Direction::UP, Simulator::Direction::UP});
+        b3.update({Simulator::Direction::UP, Simulator::Direction::UP});
+    }
+
+    REQUIRE(b1 == b2);
+    REQUIRE(b1.get_hash() == b2.get_hash());
+    REQUIRE(b1.get_hash() != b3.get_hash());
+}
+
+TEST_CASE("BitBoard random games match Board") {
+    std::mt19937 rng(1234);
+
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 5}, 3),
+        Simulator::Snake({5, 1}, 3),
+        Simulator::Snake({5, 5}, 3),
+    };
+
+    const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(snakes.size()), 1, 15, 100, false};
+
+    for (unsigned int game = 0; game < 50; game++) {
+        Grid<bool> foodGrid(ruleset.w, ruleset.h);
+        unsigned int foodCount = 0;
+        for (unsigned int i = 0; i < 6; i++) {
+            const unsigned int x = rng() % ruleset.w;
+            const unsigned int y = rng() % ruleset.h;
+            if (!foodGrid(x, y)) {
+                foodGrid(x, y) = true;
+                foodCount++;
+            }
+        }
+
+        Simulator::Board board(snakes, Simulator::FoodGrid{foodGrid, foodCount}, ruleset);
+        Simulator::BitBoard bitBoard(board);
+
+        while (!board.is_game_over()) {
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < board.get_snake_count(); i++) {
+                // Bias towards safe moves so that games last long enough to be interesting
+                if (!board.is_alive(i)) continue;
+                const Simulator::Position head = board.get_snake(i).get_head();
+                std::vector<Simulator::Direction> safeMoves;
+                for (Simulator::Direction move : {Simulator::Direction::UP, Simulator::Direction::DOWN, Simulator::Direction::LEFT, Simulator::Direction::RIGHT}) {
+                    if (board.is_safe_cell(i, Simulator::update_position(head, move))) {
+                        safeMoves.push_back(move);
+                    }
+                }
+                moves[i] = (!safeMoves.empty() && rng() % 8 != 0)
+                    ? safeMoves[rng() % safeMoves.size()]
+                    : static_cast<Simulator::Direction>(rng() % 4);
+            }
+
+            board.update(moves);
+            bitBoard.update(moves);
+            require_equivalent(board, bitBoard);
+
+            // Both boards use the same keys, so the incremental hashes agree with each other and with a rebuild
+            const Simulator::BitBoard rebuilt(board);
+            REQUIRE(rebuilt == bitBoard);
+            REQUIRE(rebuilt.get_hash() == bitBoard.get_hash());
+            REQUIRE(board.get_hash() == bitBoard.get_hash());
+        }
+    }
+}
+
+TEST_CASE("BitBoard safe move mask and closest food match full scans") {
+    std::mt19937 rng(77);
+
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 5}, 4),
+        Simulator::Snake({5, 1}, 3),
+    };
+
+    const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(snakes.size()), 3, 30, 100, true};
+
+    for (unsigned int game = 0; game < 30; game++) {
+        Simulator::Board board(snakes, Simulator::FoodGrid{Grid<bool>(ruleset.w, ruleset.h), 0}, ruleset, game);
+        Simulator::BitBoard bitBoard(board, game);
+
+        while (!bitBoard.is_game_over()) {
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < bitBoard.get_snake_count(); i++) {
+                const unsigned int mask = bitBoard.get_safe_move_mask(i);
+                for (unsigned int j = 0; j < 4; j++) {
+                    const Simulator::Direction move = static_cast<Simulator::Direction>(j);
+                    const bool safe = bitBoard.is_alive(i) && bitBoard.is_safe_cell(i, Simulator::update_position(bitBoard.get_head(i), move));
+                    REQUIRE(((mask >> j) & 1) == safe);
+                }
+                moves[i] = static_cast<Simulator::Direction>(rng() % 4);
+            }
+
+            // The closest food is the first of the closest in row major order
+            const Simulator::Position from{static_cast<int>(rng() % ruleset.w), static_cast<int>(rng() % ruleset.h)};
+            std::optional<Simulator::Position> expected;
+            unsigned int expectedDistance = std::numeric_limits<unsigned int>::max();
+            for (int y = 0; y < static_cast<int>(ruleset.h); y++) {
+                for (int x = 0; x < static_cast<int>(ruleset.w); x++) {
+                    const unsigned int distance = std::abs(x - from.x) + std::abs(y - from.y);
+                    if (bitBoard.has_food({x, y}) && distance < expectedDistance) {
+                        expected = Simulator::Position{x, y};
+                        expectedDistance = distance;
+                    }
+                }
+            }
+            REQUIRE(bitBoard.get_closest_food(from) == expected);
+
+            bitBoard.update(moves);
+        }
+    }
+}
+
+TEST_CASE("Specialised BitBoards match generic BitBoard") {
+    std::mt19937 rng(1357);
+
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 5}, 3),
+        Simulator::Snake({5, 1}, 3),
+        Simulator::Snake({5, 5}, 3),
+    };
+
+    const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(snakes.size()), 2, 50, 100, true};
+    const Simulator::FoodGrid food{Grid<bool>(ruleset.w, ruleset.h), 0};
+
+    for (unsigned int game = 0; game < 20; game++) {
+        const Simulator::Board board(snakes, food, ruleset);
+        REQUIRE(Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>>::is_supported(board));
+        REQUIRE(!Simulator::BasicBitBoard<Simulator::FixedGeometry<11, 11>>::is_supported(board));
+
+        Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>> fixed(board, game);
+        Simulator::BitBoard generic(board, game);
+
+        while (!generic.is_game_over()) {
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < generic.get_snake_count(); i++) {
+                moves[i] = static_cast<Simulator::Direction>(rng() % 4);
+            }
+
+            fixed.update(moves);
+            generic.update(moves);
+
+            // Same food is spawned, so the two boards stay identical
+            REQUIRE(fixed.get_hash() == generic.get_hash());
+            REQUIRE(fixed.to_string() == generic.to_string());
+            REQUIRE(fixed.is_game_over() == generic.is_game_over());
+        }
+    }
+}
+
+TEST_CASE("BitBoard unmake_move restores board") {
+    std::mt19937 rng(4321);
+
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 5}, 3),
+        Simulator::Snake({5, 1}, 3),
+        Simulator::Snake({5, 5}, 3),
+    };
+
+    // Spawning is left on so that unmake has to remove spawned food as well
+    const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(snakes.size()), 2, 50, 100, true};
+    const Simulator::FoodGrid food{Grid<bool>(ruleset.w, ruleset.h), 0};
+
+    for (unsigned int game = 0; game < 50; game++) {
+        Simulator::BitBoard bitBoard(Simulator::Board(snakes, food, ruleset));
+
+        std::vector<Simulator::BitBoard> history;
+        std::vector<Simulator::BitBoard::Undo> undos;
+        while (!bitBoard.is_game_over()) {
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < bitBoard.get_snake_count(); i++) {
+                moves[i] = static_cast<Simulator::Direction>(rng() % 4);
+            }
+
+            history.push_back(bitBoard);
+            undos.push_back(bitBoard.make_move(moves));
+            const Simulator::BitBoard played = bitBoard;
+
+            // Undo straight away as well, then replay the move to continue the game
+            bitBoard.unmake_move(undos.back());
+            REQUIRE(bitBoard == history.back());
+            undos.back() = bitBoard.make_move(moves);
+
+            // The generator is restored as well, so the replay spawns the same food
+            REQUIRE(bitBoard == played);
+        }
+
+        while (!undos.empty()) {
+            bitBoard.unmake_move(undos.back());
+            REQUIRE(bitBoard == history.back());
+            REQUIRE(bitBoard.get_hash() == history.back().get_hash());
+            REQUIRE(bitBoard.get_food_count() == history.back().get_food_count());
+            undos.pop_back();
+            history.pop_back();
+        }
+    }
+}
+
+TEST_CASE("BitBoard territory matches cell by cell search") {
+    std::mt19937 rng(2468);
+
+    // Alone on the board a snake owns every cell once its tail moves on
+    {
+        const Simulator::Board board({Simulator::Snake({3, 3}, 3)}, Simulator::FoodGrid{Grid<bool>(7, 7), 0}, Simulator::Ruleset{7, 7, 1, 0, 0, 100, false});
+        const Simulator::Territory territory = Simulator::BitBoard(board).get_territory();
+        REQUIRE(territory.reachable[0] == 49);
+        REQUIRE(territory.owned[0] == 49);
+    }
+
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 5}, 4),
+        Simulator::Snake({5, 1}, 3),
+        Simulator::Snake({5, 5}, 5),
+    };
+
+    const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(snakes.size()), 3, 30, 100, false};
+
+    for (unsigned int game = 0; game < 30; game++) {
+        Simulator::Board board(snakes, Simulator::FoodGrid{Grid<bool>(ruleset.w, ruleset.h), 0}, ruleset, game);
+
+        while (!board.is_game_over()) {
+            const Simulator::Territory expected = reference_territory(board);
+            const Simulator::Territory generic = Simulator::BitBoard(board).get_territory();
+            const Simulator::Territory fixed = Simulator::BasicBitBoard<Simulator::FixedGeometry<7, 7>>(board).get_territory();
+            for (unsigned int i = 0; i < board.get_snake_count(); i++) {
+                REQUIRE(generic.reachable[i] == expected.reachable[i]);
+                REQUIRE(generic.owned[i] == expected.owned[i]);
+                REQUIRE(fixed.reachable[i] == expected.reachable[i]);
+                REQUIRE(fixed.owned[i] == expected.owned[i]);
+            }
+
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < board.get_snake_count(); i++) {
+                if (!board.is_alive(i)) continue;
+                const Simulator::Position head = board.get_snake(i).get_head();
+                std::vector<Simulator::Direction> safeMoves;
+                for (Simulator::Direction move : {Simulator::Direction::UP, Simulator::Direction::DOWN, Simulator::Direction::LEFT, Simulator::Direction::RIGHT}) {
+                    if (board.is_safe_cell(i, Simulator::update_position(head, move))) {
+                        safeMoves.push_back(move);
+                    }
+                }
+                moves[i] = safeMoves.empty() ? Simulator::Direction::UP : safeMoves[rng() % safeMoves.size()];
+            }
+            board.update(moves);
+        }
+    }
+}
+
+TEST_CASE("Symmetries map positions and directions consistently") {
+    using Simulator::Position;
+
+    for (unsigned int s = 0; s < Simulator::SYMMETRY_COUNT; s++) {
+        const unsigned int inverse = Simulator::inverse_symmetry(s);
+        for (const Position position : {Position{0, 0}, Position{3, 1}, Position{6, 2}, Position{2, 6}}) {
+            const Position image = Simulator::transform_position(s, position, 7, 7);
+            REQUIRE(Simulator::transform_position(inverse, image, 7, 7) == position);
+
+            // A step keeps its direction under the symmetry
+            for (unsigned int d = 0; d < 4; d++) {
+                const Simulator::Direction direction = static_cast<Simulator::Direction>(d);
+                const Simulator::Direction turned = Simulator::transform_direction(s, direction);
+                const Position stepImage = Simulator::transform_position(s, Simulator::update_position(position, direction), 7, 7);
+                REQUIRE(Simulator::update_position(image, turned) == stepImage);
+                REQUIRE(Simulator::transform_direction(inverse, turned) == direction);
+            }
+        }
+    }
+
+    REQUIRE(Simulator::get_symmetry_count(11, 11) == 8);
+    REQUIRE(Simulator::get_symmetry_count(11, 7) == 4);
+}
+
+TEST_CASE("BitBoard symmetric hashes match hashes of transformed boards") {
+    std::mt19937 rng(2468);
+
+    // A non square board only has its mirrors
+    for (const auto& [w, h] : {std::pair{7u, 7u}, std::pair{9u, 6u}}) {
+        const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({static_cast<int>(w) - 2, 3}, 3),
+        };
+        const Simulator::Ruleset ruleset{w, h, static_cast<unsigned int>(snakes.size()), 2, 50, 100, true};
+        const Simulator::FoodGrid food{Grid<bool>(w, h), 0};
+
+        for (unsigned int game = 0; game < 20; game++) {
+            Simulator::Board board(snakes, food, ruleset, game);
+
+            while (board.is_alive(0) && board.is_alive(1)) {
+                const Simulator::BitBoard bitBoard(board);
+                const std::array<uint64_t, Simulator::SYMMETRY_COUNT> hashes = bitBoard.get_symmetric_hashes();
+                REQUIRE(hashes[Simulator::IDENTITY_SYMMETRY] == board.get_hash());
+                for (unsigned int s = 0; s < Simulator::get_symmetry_count(w, h); s++) {
+                    REQUIRE(hashes[s] == transform_board(board, s).get_hash());
+                }
+
+                Simulator::MoveArray moves{};
+                for (unsigned int i = 0; i < board.get_snake_count(); i++) {
+                    std::vector<Simulator::Direction> safe;
+                    for (unsigned int d = 0; d < 4; d++) {
+                        if ((bitBoard.get_safe_move_mask(i) >> d) & 1) {
+                            safe.push_back(static_cast<Simulator::Direction>(d));
+                        }
+                    }
+                    moves[i] = safe.empty() ? Simulator::Direction::UP : safe[rng() % safe.size()];
+                }
+                board.update(moves);
+            }
+        }
+    }
+}
+
+TEST_CASE("BitBoard keeps tracked symmetric hashes through make_move and unmake_move") {
+    std::mt19937 rng(1357);
+
+    for (const auto& [w, h] : {std::pair{7u, 7u}, std::pair{9u, 6u}}) {
+        const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({static_cast<int>(w) - 2, 3}, 3),
+            Simulator::Snake({3, static_cast<int>(h) - 2}, 3),
+        };
+        const Simulator::Ruleset ruleset{w, h, static_cast<unsigned int>(snakes.size()), 2, 50, 100, true};
+        const Simulator::FoodGrid food{Grid<bool>(w, h), 0};
+
+        for (unsigned int game = 0; game < 20; game++) {
+            Simulator::BitBoard board(Simulator::Board(snakes, food, ruleset), game);
+            board.track_symmetric_hashes(true);
+            const std::array<uint64_t, Simulator::SYMMETRY_COUNT> start = board.get_symmetric_hashes();
+
+            // Moves are random, so snakes also die against walls and bodies
+            std::vector<Simulator::BitBoard::Undo> undos;
+            while (!board.is_game_over()) {
+                Simulator::MoveArray moves{};
+                for (unsigned int i = 0; i < board.get_snake_count(); i++) {
+                    moves[i] = static_cast<Simulator::Direction>(rng() % 4);
+                }
+                undos.push_back(board.make_move(moves));
+
+                Simulator::BitBoard untracked = board;
+                untracked.track_symmetric_hashes(false);
+                REQUIRE(board.get_symmetric_hashes() == untracked.get_symmetric_hashes());
+            }
+
+            for (auto it = undos.rbegin(); it != undos.rend(); ++it) {
+                board.unmake_move(*it);
+            }
+            REQUIRE(board.get_symmetric_hashes() == start);
+        }
+    }
+}
@@ -1,13 +1,28 @@
+#include <algorithm>
+#include <random>
+
 #include <catch2/catch.hpp>
 
 #include "../simulator.hpp"
 
+namespace {
+
+    unsigned int count_alive(const Simulator::Board& t_board) {
+        unsigned int result = 0;
+        for (unsigned int i = 0; i < t_board.get_snake_count(); i++) {
+            result += t_board.is_alive(i);
+        }
+        return result;
+    }
+
+}
+
 TEST_CASE("Board constructor correct") {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-        {"a", Simulator::Snake({1, 1}, 3)},
-        {"b", Simulator::Snake({1, 9}, 3)},
-        {"c", Simulator::Snake({9, 1}, 3)},
-        {"d", Simulator::Snake({9, 9}, 3)},
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({1, 9}, 3),
+        Simulator::Snake({9, 1}, 3),
+        Simulator::Snake({9, 9}, 3),
     };
 
     const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
@@ -16,17 +31,20 @@ TEST_CASE("Board constructor correct") {
 
     REQUIRE(board.get_ruleset() == Simulator::DEFAULT_RULESET);
     REQUIRE(board.is_game_over() == false);
-    REQUIRE(board.get_winner() == nullptr);
-    REQUIRE(board.get_snakes() == snakes);
+    REQUIRE(board.get_winner() == board.get_snake_count());
+    REQUIRE(board.get_snake_count() == snakes.size());
+    for (unsigned int i = 0; i < snakes.size(); i++) {
+        REQUIRE(board.get_snake(i) == snakes[i]);
+    }
     REQUIRE(board.get_food() == food);
 }
 
 TEST_CASE("Board is_in_bounds correct") {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-            {"a", Simulator::Snake({1, 1}, 3)},
-            {"b", Simulator::Snake({1, 9}, 3)},
-            {"c", Simulator::Snake({9, 1}, 3)},
-            {"d", Simulator::Snake({9, 9}, 3)},
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({1, 9}, 3),
+            Simulator::Snake({9, 1}, 3),
+            Simulator::Snake({9, 9}, 3),
     };
 
     const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
@@ -53,40 +71,39 @@ TEST_CASE("Board is_in_bounds correct") {
     REQUIRE(board.is_in_bounds({w, -1}) == false);
 }
 
-TEST_CASE("Board is_valid_id correct") {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-            {"a", Simulator::Snake({1, 1}, 3)},
-            {"b", Simulator::Snake({1, 9}, 3)},
-            {"c", Simulator::Snake({9, 1}, 3)},
-            {"d", Simulator::Snake({9, 9}, 3)},
+TEST_CASE("Board is_alive correct") {
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({1, 9}, 3),
+            Simulator::Snake({9, 1}, 3),
+            Simulator::Snake({9, 9}, 3),
     };
 
     const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
 
     const Simulator::Board board(snakes, food, Simulator::DEFAULT_RULESET);
 
-    REQUIRE(board.is_valid_id("a") == true);
-    REQUIRE(board.is_valid_id("b") == true);
-    REQUIRE(board.is_valid_id("c") == true);
-    REQUIRE(board.is_valid_id("d") == true);
+    REQUIRE(board.is_alive(0) == true);
+    REQUIRE(board.is_alive(1) == true);
+    REQUIRE(board.is_alive(2) == true);
+    REQUIRE(board.is_alive(3) == true);
 
-    REQUIRE(board.is_valid_id("") == false);
-    REQUIRE(board.is_valid_id("e") == false);
+    REQUIRE(board.is_alive(4) == false);
 }
 
 TEST_CASE("Board operator== correct") {
-    const std::unordered_map<std::string, Simulator::Snake> s1 {
-            {"a", Simulator::Snake({1, 1}, 3)},
-            {"b", Simulator::Snake({1, 9}, 3)},
-            {"c", Simulator::Snake({9, 1}, 3)},
-            {"d", Simulator::Snake({9, 9}, 3)},
+    const std::vector<Simulator::Snake> s1 {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({1, 9}, 3),
+            Simulator::Snake({9, 1}, 3),
+            Simulator::Snake({9, 9}, 3),
     };
 
-    const std::unordered_map<std::string, Simulator::Snake> s2 {
-            {"a", Simulator::Snake({1, 1}, 4)},
-            {"b", Simulator::Snake({1, 9}, 4)},
-            {"c", Simulator::Snake({9, 1}, 4)},
-            {"d", Simulator::Snake({9, 9}, 4)},
+    const std::vector<Simulator::Snake> s2 {
+            Simulator::Snake({1, 1}, 4),
+            Simulator::Snake({1, 9}, 4),
+            Simulator::Snake({9, 1}, 4),
+            Simulator::Snake({9, 9}, 4),
     };
 
     const Simulator::Ruleset r1{10, 10, static_cast<unsigned int>(s1.size()), 1, 15, 100, true};
@@ -198,27 +215,27 @@ TEST_CASE("Board operator== correct") {
 }
 
 TEST_CASE("Board update out of bounds correct") {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-            {"a", Simulator::Snake({1, 1}, 3)},
-            {"b", Simulator::Snake({1, 9}, 3)},
-            {"c", Simulator::Snake({9, 1}, 3)},
-            {"d", Simulator::Snake({9, 9}, 3)},
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({1, 9}, 3),
+            Simulator::Snake({9, 1}, 3),
+            Simulator::Snake({9, 9}, 3),
     };
 
     const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
 
-    const std::unordered_map<std::string, Simulator::Direction> m1 {
-            {"a", Simulator::Direction::UP},
-            {"b", Simulator::Direction::UP},
-            {"c", Simulator::Direction::UP},
-            {"d", Simulator::Direction::UP},
+    const Simulator::MoveArray m1 {
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
     };
 
-    const std::unordered_map<std::string, Simulator::Direction> m2 {
-            {"a", Simulator::Direction::LEFT},
-            {"b", Simulator::Direction::LEFT},
-            {"c", Simulator::Direction::LEFT},
-            {"d", Simulator::Direction::LEFT},
+    const Simulator::MoveArray m2 {
+            Simulator::Direction::LEFT,
+            Simulator::Direction::LEFT,
+            Simulator::Direction::LEFT,
+            Simulator::Direction::LEFT,
     };
 
     const Simulator::Board initialBoard(snakes, food, Simulator::DEFAULT_RULESET);
@@ -227,104 +244,104 @@ TEST_CASE("Board update out of bounds correct") {
 
     board.update(m1);
     REQUIRE(!(board == initialBoard));
-    REQUIRE(board.get_snakes().size() == 4);
+    REQUIRE(count_alive(board) == 4);
     REQUIRE(board.is_game_over() == false);
-    REQUIRE(board.get_winner() == nullptr);
+    REQUIRE(board.get_winner() == board.get_snake_count());
 
     board.update(m1);
-    REQUIRE(board.get_snakes().size() == 2);
+    REQUIRE(count_alive(board) == 2);
     REQUIRE(board.is_game_over() == false);
-    REQUIRE(board.get_winner() == nullptr);
+    REQUIRE(board.get_winner() == board.get_snake_count());
 
     board.update(m2);
     board.update(m2);
-    REQUIRE(board.get_snakes().size() == 1);
+    REQUIRE(count_alive(board) == 1);
     REQUIRE(board.is_game_over() == true);
-    REQUIRE(*board.get_winner() == "d");
+    REQUIRE(board.get_winner() == 3);
 
 }
 
 TEST_CASE("Board update ran out of health correct") {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-            {"a", Simulator::Snake({1, 9}, 3, 1)},
-            {"b", Simulator::Snake({2, 9}, 3, 2)},
-            {"c", Simulator::Snake({3, 9}, 3, 3)},
-            {"d", Simulator::Snake({4, 9}, 3, 4)},
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 9}, 3, 1),
+            Simulator::Snake({2, 9}, 3, 2),
+            Simulator::Snake({3, 9}, 3, 3),
+            Simulator::Snake({4, 9}, 3, 4),
     };
 
     const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
 
-    const std::unordered_map<std::string, Simulator::Direction> m1 {
-            {"a", Simulator::Direction::UP},
-            {"b", Simulator::Direction::UP},
-            {"c", Simulator::Direction::UP},
-            {"d", Simulator::Direction::UP},
+    const Simulator::MoveArray m1 {
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
     };
 
     Simulator::Board board(snakes, food, Simulator::DEFAULT_RULESET);
 
     board.update(m1);
-    REQUIRE(board.get_snakes().size() == 3);
+    REQUIRE(count_alive(board) == 3);
     REQUIRE(board.is_game_over() == false);
-    REQUIRE(board.get_winner() == nullptr);
+    REQUIRE(board.get_winner() == board.get_snake_count());
 
     board.update(m1);
-    REQUIRE(board.get_snakes().size() == 2);
+    REQUIRE(count_alive(board) == 2);
     REQUIRE(board.is_game_over() == false);
-    REQUIRE(board.get_winner() == nullptr);
+    REQUIRE(board.get_winner() == board.get_snake_count());
 
     board.update(m1);
-    REQUIRE(board.get_snakes().size() == 1);
+    REQUIRE(count_alive(board) == 1);
     REQUIRE(board.is_game_over() == true);
-    REQUIRE(*board.get_winner() == "d");
+    REQUIRE(board.get_winner() == 3);
 }
 
 TEST_CASE("Board update head on collision correct") {
-    const std::unordered_map<std::string, Simulator::Snake> s1 {
-            {"a", Simulator::Snake({0, 0}, 3)},
-            {"b", Simulator::Snake({2, 0}, 3)},
+    const std::vector<Simulator::Snake> s1 {
+            Simulator::Snake({0, 0}, 3),
+            Simulator::Snake({2, 0}, 3),
     };
 
-    const std::unordered_map<std::string, Simulator::Snake> s2 {
-            {"a", Simulator::Snake({0, 0}, 4)},
-            {"b", Simulator::Snake({2, 0}, 3)},
+    const std::vector<Simulator::Snake> s2 {
+            Simulator::Snake({0, 0}, 4),
+            Simulator::Snake({2, 0}, 3),
     };
 
-    const std::unordered_map<std::string, Simulator::Snake> s3 {
-            {"a", Simulator::Snake({0, 0}, 3)},
-            {"b", Simulator::Snake({2, 0}, 4)},
+    const std::vector<Simulator::Snake> s3 {
+            Simulator::Snake({0, 0}, 3),
+            Simulator::Snake({2, 0}, 4),
     };
 
     const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
 
-    const std::unordered_map<std::string, Simulator::Direction> moves {
-            {"a", Simulator::Direction::RIGHT},
-            {"b", Simulator::Direction::LEFT},
+    const Simulator::MoveArray moves {
+            Simulator::Direction::RIGHT,
+            Simulator::Direction::LEFT,
     };
 
     Simulator::Board b1(s1, food, Simulator::DEFAULT_RULESET);
     b1.update(moves);
-    REQUIRE(b1.get_snakes().size() == 0);
+    REQUIRE(count_alive(b1) == 0);
     REQUIRE(b1.is_game_over() == true);
-    REQUIRE(b1.get_winner() == nullptr);
+    REQUIRE(b1.get_winner() == b1.get_snake_count());
 
     Simulator::Board b2(s2, food, Simulator::DEFAULT_RULESET);
     b2.update(moves);
-    REQUIRE(b2.get_snakes().size() == 1);
+    REQUIRE(count_alive(b2) == 1);
     REQUIRE(b2.is_game_over() == true);
-    REQUIRE(*b2.get_winner() == "a");
+    REQUIRE(b2.get_winner() == 0);
 
     Simulator::Board b3(s3, food, Simulator::DEFAULT_RULESET);
     b3.update(moves);
-    REQUIRE(b3.get_snakes().size() == 1);
+    REQUIRE(count_alive(b3) == 1);
     REQUIRE(b3.is_game_over() == true);
-    REQUIRE(*b3.get_winner() == "b");
+    REQUIRE(b3.get_winner() == 1);
 }
 
 TEST_CASE("Board update consume food correct") {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-            {"a", Simulator::Snake({1, 9}, 3)},
-            {"b", Simulator::Snake({2, 9}, 3)},
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 9}, 3),
+            Simulator::Snake({2, 9}, 3),
     };
 
     Grid<bool> foodGrid(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h);
@@ -334,25 +351,25 @@ TEST_CASE("Board update consume food correct") {
 
     const Simulator::Ruleset ruleset{10, 10, static_cast<unsigned int>(snakes.size()), 1, 15, 100, false};
 
-    const std::unordered_map<std::string, Simulator::Direction> moves {
-            {"a", Simulator::Direction::UP},
-            {"b", Simulator::Direction::UP},
+    const Simulator::MoveArray moves {
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
     };
 
     Simulator::Board board(snakes, food, ruleset);
     board.update(moves);
-    REQUIRE(board.get_snake("a").get_health() == 100);
-    REQUIRE(board.get_snake("a").get_length() == 4);
-    REQUIRE(board.get_snake("b").get_health() == 99);
-    REQUIRE(board.get_snake("b").get_length() == 3);
+    REQUIRE(board.get_snake(0).get_health() == 100);
+    REQUIRE(board.get_snake(0).get_length() == 4);
+    REQUIRE(board.get_snake(1).get_health() == 99);
+    REQUIRE(board.get_snake(1).get_length() == 3);
     REQUIRE(board.get_food().cells(1, 8) == false);
     REQUIRE(board.get_food().count == 0);
 }
 
 TEST_CASE("Board update spawn food correct") {
-    const std::unordered_map<std::string, Simulator::Snake> snakes {
-            {"a", Simulator::Snake({1, 9}, 3)},
-            {"b", Simulator::Snake({2, 9}, 3)},
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 9}, 3),
+            Simulator::Snake({2, 9}, 3),
     };
 
     const Grid<bool> foodGrid(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h);
@@ -361,9 +378,9 @@ TEST_CASE("Board update spawn food correct") {
     const Simulator::Ruleset r1{10, 10, static_cast<unsigned int>(snakes.size()), 10, 15, 100, false};
     const Simulator::Ruleset r2{10, 10, static_cast<unsigned int>(snakes.size()), 10, 15, 100, true};
 
-    const std::unordered_map<std::string, Simulator::Direction> moves {
-            {"a", Simulator::Direction::UP},
-            {"b", Simulator::Direction::UP},
+    const Simulator::MoveArray moves {
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
     };
 
     Simulator::Board b1(snakes, food, r1);
@@ -376,3 +393,278 @@ TEST_CASE("Board update spawn food correct") {
     REQUIRE(b1.get_food().count == 0);
     REQUIRE(b2.get_food().count == 10);
 }
+
+TEST_CASE("Board spawn food reproducible from seed") {
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 9}, 3),
+            Simulator::Snake({2, 9}, 3),
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(10, 10), 0};
+    const Simulator::Ruleset ruleset{10, 10, static_cast<unsigned int>(snakes.size()), 5, 50, 100, true};
+
+    Simulator::Board b1(snakes, food, ruleset, 42);
+    Simulator::Board b2(snakes, food, ruleset, 42);
+    Simulator::Board b3(snakes, food, ruleset, 43);
+
+    const Simulator::MoveArray moves {
+            Simulator::Direction::UP,
+            Simulator::Direction::UP,
+    };
+    for (unsigned int i = 0; i < 4; i++) {
+        b1.update(moves);
+        b2.update(moves);
+        b3.update(moves);
+    }
+
+    REQUIRE(b1 == b2);
+    REQUIRE(b1.get_hash() == b2.get_hash());
+    REQUIRE(b1.get_hash() != b3.get_hash());
+
+    // A copy continues the sequence of the original
+    Simulator::Board copy(b1, ruleset);
+    b1.update(moves);
+    copy.update(moves);
+    REQUIRE(b1.get_hash() == copy.get_hash());
+}
+
+TEST_CASE("Board is_safe_cell correct") {
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({{1, 1}, {2, 1}, {3, 1}}, 100),
+            Simulator::Snake({{3, 3}, {3, 2}}, 100),
+            Simulator::Snake({7, 7}, 3),
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(Simulator::DEFAULT_RULESET.w, Simulator::DEFAULT_RULESET.h), 0};
+
+    const Simulator::Board board(snakes, food, Simulator::DEFAULT_RULESET);
+
+    // Body segments, including tails, are never safe
+    REQUIRE(board.is_safe_cell(0, {1, 1}) == false);
+    REQUIRE(board.is_safe_cell(0, {2, 1}) == false);
+    REQUIRE(board.is_safe_cell(1, {2, 1}) == false);
+    REQUIRE(board.is_safe_cell(0, {3, 3}) == false);
+
+    // Heads are only safe for their own snake or for longer snakes
+    REQUIRE(board.is_safe_cell(0, {3, 1}) == true);
+    REQUIRE(board.is_safe_cell(1, {3, 1}) == false);
+    REQUIRE(board.is_safe_cell(0, {3, 2}) == true);
+    REQUIRE(board.is_safe_cell(1, {3, 2}) == true);
+
+    // A head with every segment stacked on it is body as well
+    REQUIRE(board.is_safe_cell(2, {7, 7}) == false);
+    REQUIRE(board.is_safe_cell(0, {7, 7}) == false);
+
+    REQUIRE(board.is_safe_cell(0, {5, 5}) == true);
+    REQUIRE(board.is_safe_cell(0, {-1, 5}) == false);
+    REQUIRE(board.is_safe_cell(4, {5, 5}) == false);
+}
+
+TEST_CASE("Board update tail chasing correct") {
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({{1, 1}, {2, 1}, {2, 2}, {1, 2}}, 100),
+            Simulator::Snake({{5, 1}, {5, 2}, {5, 3}}, 100),
+            Simulator::Snake({{7, 2}, {7, 1}, {6, 1}}, 100),
+    };
+
+    Simulator::Ruleset ruleset = Simulator::DEFAULT_RULESET;
+    ruleset.spawnFood = false;
+
+    const Simulator::FoodGrid food{Grid<bool>(ruleset.w, ruleset.h), 0};
+
+    // a follows its own tail, c moves onto the tail b vacates
+    const Simulator::MoveArray moves {
+            Simulator::Direction::UP,
+            Simulator::Direction::LEFT,
+            Simulator::Direction::LEFT,
+    };
+
+    Simulator::Board board(snakes, food, ruleset);
+    board.update(moves);
+    REQUIRE(count_alive(board) == 3);
+    REQUIRE(board.get_snake(0).get_head() == Simulator::Position{1, 1});
+    REQUIRE(board.get_snake(2).get_head() == Simulator::Position{5, 1});
+
+    REQUIRE(board.is_safe_cell(1, {2, 1}) == false);
+    REQUIRE(board.is_safe_cell(1, {5, 1}) == false);
+    REQUIRE(board.is_safe_cell(2, {5, 1}) == true);
+    REQUIRE(board.is_safe_cell(2, {5, 2}) == false);
+    REQUIRE(board.is_safe_cell(2, {7, 2}) == true);
+
+    // b now moves into the neck of c
+    board.update({Simulator::Direction::RIGHT, Simulator::Direction::UP, Simulator::Direction::UP});
+    REQUIRE(board.is_alive(1) == true);
+    board.update({Simulator::Direction::DOWN, Simulator::Direction::UP, Simulator::Direction::LEFT});
+    REQUIRE(board.is_alive(1) == true);
+    board.update({Simulator::Direction::LEFT, Simulator::Direction::UP, Simulator::Direction::LEFT});
+    REQUIRE(board.is_alive(0) == true);
+    REQUIRE(board.is_alive(1) == false);
+    REQUIRE(board.is_alive(2) == true);
+}
+
+TEST_CASE("Board copy keeps ruleset") {
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({1, 8}, 3),
+    };
+
+    const Simulator::FoodGrid food{Grid<bool>(10, 10), 0};
+    const Simulator::Ruleset ruleset{10, 10, static_cast<unsigned int>(snakes.size()), 1, 15, 100, false};
+
+    const Simulator::Board b1(snakes, food, ruleset);
+    const Simulator::Board b2 = b1;
+    const Simulator::Board b3(b1, Simulator::DEFAULT_RULESET);
+
+    REQUIRE(b2.get_ruleset() == ruleset);
+    REQUIRE(b2 == b1);
+    REQUIRE(b3.get_ruleset() == Simulator::DEFAULT_RULESET);
+    for (unsigned int i = 0; i < snakes.size(); i++) {
+        REQUIRE(b3.get_snake(i) == b1.get_snake(i));
+    }
+
+    // Eliminated snakes stay eliminated in the copy
+    Simulator::Board b4 = b1;
+    b4.update({Simulator::Direction::LEFT, Simulator::Direction::UP});
+    b4.update({Simulator::Direction::LEFT, Simulator::Direction::UP});
+    REQUIRE(b4.is_alive(0) == false);
+
+    const Simulator::Board b5(b4, ruleset);
+    REQUIRE(b5 == b4);
+    REQUIRE(b5.is_alive(0) == false);
+    REQUIRE(b5.is_safe_cell(1, b4.get_snake(0).get_tail()) == true);
+    REQUIRE(Simulator::BoardHash{}(b5) == Simulator::BoardHash{}(b4));
+}
+
+TEST_CASE("Board hash updated incrementally") {
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({8, 8}, 3),
+    };
+
+    Grid<bool> foodGrid(10, 10);
+    foodGrid(1, 3) = true;
+    const Simulator::FoodGrid food{foodGrid, 1};
+    const Simulator::Ruleset ruleset{10, 10, static_cast<unsigned int>(snakes.size()), 1, 15, 100, false};
+
+    Simulator::Board board(snakes, food, ruleset);
+    const Simulator::Board initial = board;
+
+    // a eats on the second move, so its body is stacked and its health reset
+    for (Simulator::Direction move : {Simulator::Direction::DOWN, Simulator::Direction::DOWN, Simulator::Direction::RIGHT}) {
+        board.update({move, Simulator::Direction::UP});
+
+        const Simulator::Board rebuilt({board.get_snake(0), board.get_snake(1)}, board.get_food(), ruleset);
+        REQUIRE(rebuilt == board);
+        REQUIRE(Simulator::BoardHash{}(rebuilt) == Simulator::BoardHash{}(board));
+        REQUIRE(Simulator::BoardHash{}(initial) != Simulator::BoardHash{}(board));
+    }
+
+    // The same bodies with different health hash differently
+    std::vector<Simulator::Snake> hungry = snakes;
+    hungry[0] = board.get_snake(0);
+    hungry[0].set_health(50);
+    hungry[1] = board.get_snake(1);
+    REQUIRE(Simulator::BoardHash{}(Simulator::Board(hungry, board.get_food(), ruleset)) != Simulator::BoardHash{}(board));
+}
+
+TEST_CASE("SparseCellSet insert and erase correct") {
+    Simulator::SparseCellSet set(10);
+    REQUIRE(set.size() == 0);
+
+    set.insert(3);
+    set.insert(7);
+    set.insert(3);
+    set.insert(0);
+    REQUIRE(set.size() == 3);
+    REQUIRE(set.contains(3));
+    REQUIRE(set.contains(7));
+    REQUIRE(set.contains(0));
+    REQUIRE(!set.contains(5));
+
+    set.erase(3);
+    set.erase(5);
+    REQUIRE(set.size() == 2);
+    REQUIRE(!set.contains(3));
+
+    // The remaining members are still reachable by position
+    const unsigned int a = set[0];
+    const unsigned int b = set[1];
+    REQUIRE(std::min(a, b) == 0);
+    REQUIRE(std::max(a, b) == 7);
+}
+
+TEST_CASE("Board free cells updated incrementally") {
+    std::mt19937 rng(2468);
+
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({1, 5}, 3),
+            Simulator::Snake({5, 1}, 3),
+            Simulator::Snake({5, 5}, 3),
+    };
+
+    const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(snakes.size()), 2, 50, 100, true};
+    const Simulator::FoodGrid food{Grid<bool>(ruleset.w, ruleset.h), 0};
+
+    for (unsigned int game = 0; game < 50; game++) {
+        Simulator::Board board(snakes, food, ruleset, game);
+
+        while (!board.is_game_over()) {
+            Simulator::MoveArray moves{};
+            for (unsigned int i = 0; i < board.get_snake_count(); i++) {
+                moves[i] = static_cast<Simulator::Direction>(rng() % 4);
+            }
+            board.update(moves);
+
+            // A cell is free exactly when nothing could spawn food there
+            unsigned int freeCount = 0;
+            for (unsigned int y = 0; y < ruleset.h; y++) {
+                for (unsigned int x = 0; x < ruleset.w; x++) {
+                    const Simulator::Position pos{static_cast<int>(x), static_cast<int>(y)};
+                    bool free = !board.get_food().cells(x, y);
+                    for (unsigned int i = 0; i < board.get_snake_count() && free; i++) {
+                        if (!board.is_alive(i)) continue;
+                        const Simulator::Snake& snake = board.get_snake(i);
+                        free = std::find(snake.begin(), snake.end(), pos) == snake.end();
+                    }
+
+                    REQUIRE(board.get_free_cells().contains(y * ruleset.w + x) == free);
+                    freeCount += free;
+                }
+            }
+            REQUIRE(board.get_free_cells().size() == freeCount);
+        }
+    }
+}
+
+TEST_CASE("Board handles a food grid smaller than the board") {
+    const std::vector<Simulator::Snake> snakes {
+            Simulator::Snake({1, 1}, 3),
+            Simulator::Snake({5, 5}, 3),
+    };
+
+    // Food only covers the top left 3x3 corner of the 7x7 board
+    Grid<bool> cells(3, 3);
+    cells(1, 2) = true;
+    const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(snakes.size()), 2, 50, 100, true};
+    Simulator::Board board(snakes, Simulator::FoodGrid{cells, 1}, ruleset);
+    REQUIRE(board.has_food({1, 2}));
+    REQUIRE_FALSE(board.has_food({5, 6}));
+
+    // Snake 0 eats the food, snake 1 moves onto a cell outside the food grid
+    board.update({Simulator::Direction::DOWN, Simulator::Direction::DOWN});
+    REQUIRE(board.is_alive(0));
+    REQUIRE(board.is_alive(1));
+    REQUIRE(board.get_snake(0).get_length() == 4);
+    REQUIRE(board.get_snake(0).get_health() == ruleset.startingHealth);
+    REQUIRE(board.get_snake(1).get_length() == 3);
+
+    // Food spawned anywhere on the board is kept, and the board prints
+    for (unsigned int turn = 0; turn < 3; turn++) {
+        board.update({Simulator::Direction::RIGHT, Simulator::Direction::UP});
+    }
+    REQUIRE(board.get_food().count >= ruleset.minFood);
+    REQUIRE(board.get_food().cells.get_width() == ruleset.w);
+    REQUIRE(board.get_food().cells.get_height() == ruleset.h);
+    REQUIRE_FALSE(board.to_string().empty());
+}
@@ -0,0 +1,79 @@
+#include <optional>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../ai.hpp"
+
+namespace {
+
+    Simulator::Board make_board(const std::vector<Simulator::Snake>& t_snakes) {
+        const Simulator::Ruleset ruleset{7, 7, static_cast<unsigned int>(t_snakes.size()), 0, 0, 100, false};
+        return Simulator::Board{t_snakes, Simulator::FoodGrid{Grid<bool>(7, 7), 0}, ruleset};
+    }
+
+}
+
+TEST_CASE("endgame_player decides a duel against a boxed in snake") {
+    using Simulator::Position;
+
+    // Snake 0 walls snake 1 into the corner, where its head has nowhere to go
+    const Simulator::Snake s0({
+        Position{6, 2}, Position{6, 1}, Position{6, 0}, Position{5, 0}, Position{4, 0}, Position{3, 0}, Position{2, 0},
+        Position{2, 1}, Position{1, 1}, Position{1, 2}, Position{0, 2}, Position{0, 3}, Position{0, 4}
+    });
+    const Simulator::Snake s1({Position{0, 1}, Position{0, 0}, Position{1, 0}});
+    const Simulator::Board board = make_board({s0, s1});
+
+    AI::SearchStats stats{};
+    const std::optional<Simulator::Direction> move = AI::endgame_player(board, 0, &stats);
+    REQUIRE(move.has_value());
+    REQUIRE((*move == Simulator::Direction::DOWN || *move == Simulator::Direction::RIGHT));
+    REQUIRE(stats.nodes > 0);
+
+    // Snake 1 loses whatever it does, which decides the game as well
+    REQUIRE(AI::endgame_player(board, 1).has_value());
+}
+
+TEST_CASE("endgame_player survives by chasing its tail") {
+    using Simulator::Position;
+
+    // Snake 0 fills the corner and only lives on by moving onto its tail,
+    // snake 1 seals it in and starves on the next turn
+    const Simulator::Snake s0({Position{0, 0}, Position{1, 0}, Position{1, 1}, Position{0, 1}});
+    const Simulator::Snake s1({
+        Position{6, 0}, Position{5, 0}, Position{4, 0}, Position{3, 0}, Position{2, 0},
+        Position{2, 1}, Position{2, 2}, Position{1, 2}, Position{0, 2}, Position{0, 3}
+    }, 1);
+    const Simulator::Board board = make_board({s0, s1});
+
+    REQUIRE(AI::endgame_player(board, 0) == Simulator::Direction::UP);
+}
+
+TEST_CASE("endgame_player leaves snakes that are not separated to the search") {
+    const Simulator::Board board = make_board({Simulator::Snake({2, 3}, 3), Simulator::Snake({4, 3}, 3)});
+
+    AI::SearchStats stats{};
+    REQUIRE_FALSE(AI::endgame_player(board, 0, &stats).has_value());
+    REQUIRE_FALSE(AI::endgame_player(board, 1).has_value());
+    REQUIRE(stats.nodes == 0);
+}
+
+TEST_CASE("endgame_player reads food from a grid smaller than the board") {
+    using Simulator::Position;
+
+    // The tail chasing position with food in a grid that only covers the top
+    // left of the board, too far away for the starving snake 1 to reach
+    const Simulator::Snake s0({Position{0, 0}, Position{1, 0}, Position{1, 1}, Position{0, 1}});
+    const Simulator::Snake s1({
+        Position{6, 0}, Position{5, 0}, Position{4, 0}, Position{3, 0}, Position{2, 0},
+        Position{2, 1}, Position{2, 2}, Position{1, 2}, Position{0, 2}, Position{0, 3}
+    }, 1);
+
+    Grid<bool> cells(3, 4);
+    cells(2, 3) = true;
+    const Simulator::Ruleset ruleset{7, 7, 2, 0, 0, 100, false};
+    const Simulator::Board board{{s0, s1}, Simulator::FoodGrid{cells, 1}, ruleset};
+
+    REQUIRE(AI::endgame_player(board, 0) == Simulator::Direction::UP);
+}
@@ -0,0 +1,51 @@
+#include <utility>
+
+#include <catch2/catch.hpp>
+
+#include "../geometry.hpp"
+
+namespace {
+
+    template <class Geometry>
+    void require_neighbours_correct(const Geometry& t_geometry) {
+        for (unsigned int cell = 0; cell < t_geometry.get_cell_count(); cell++) {
+            const Simulator::Position position = t_geometry.to_position(cell);
+            REQUIRE(t_geometry.to_cell(position) == cell);
+
+            for (Simulator::Direction direction : {Simulator::Direction::UP, Simulator::Direction::DOWN, Simulator::Direction::LEFT, Simulator::Direction::RIGHT}) {
+                const Simulator::Position next = Simulator::update_position(position, direction);
+                const unsigned int expected = t_geometry.is_in_bounds(next) ? t_geometry.to_cell(next) : Simulator::OFF_BOARD;
+                REQUIRE(t_geometry.neighbour(cell, direction) == expected);
+            }
+        }
+    }
+
+}
+
+TEST_CASE("FixedGeometry neighbours correct") {
+    require_neighbours_correct(Simulator::FixedGeometry<7, 7>(7, 7));
+    require_neighbours_correct(Simulator::FixedGeometry<11, 11>(11, 11));
+    require_neighbours_correct(Simulator::FixedGeometry<19, 19>(19, 19));
+
+    static_assert(Simulator::FixedGeometry<11, 11>(11, 11).neighbour(0, Simulator::Direction::UP) == Simulator::OFF_BOARD);
+    static_assert(Simulator::FixedGeometry<11, 11>(11, 11).neighbour(0, Simulator::Direction::DOWN) == 11);
+}
+
+TEST_CASE("DynamicGeometry neighbours correct") {
+    require_neighbours_correct(Simulator::DynamicGeometry(11, 11));
+    require_neighbours_correct(Simulator::DynamicGeometry(9, 5));
+    require_neighbours_correct(Simulator::DynamicGeometry(1, 3));
+}
+
+TEST_CASE("dispatch_geometry correct") {
+    const auto dispatch = [](unsigned int t_w, unsigned int t_h) {
+        return Simulator::dispatch_geometry(t_w, t_h, [](auto t_geometry) {
+            return std::make_pair(decltype(t_geometry)::CAPACITY, t_geometry.get_width());
+        });
+    };
+
+    REQUIRE(dispatch(7, 7) == std::make_pair(7u * 7u, 7u));
+    REQUIRE(dispatch(11, 11) == std::make_pair(11u * 11u, 11u));
+    REQUIRE(dispatch(19, 19) == std::make_pair(19u * 19u, 19u));
+    REQUIRE(dispatch(9, 5) == std::make_pair(Simulator::MAX_BOARD_CELLS, 9u));
+}
@@ -1,3 +1,5 @@
+#include <random>
+
 #include <catch2/catch.hpp>
 
 #include "../simulator.hpp"
@@ -133,3 +135,128 @@ TEST_CASE("Grid<int> operator== correct") {
     REQUIRE(g5 == g4);
     REQUIRE(g5 == g5);
 }
+
+TEST_CASE("BitGrid bitwise operations correct") {
+    // Tall enough for the four row vector path and the scalar remainder
+    BitGrid a(11, 11);
+    BitGrid b(11, 11);
+    for (unsigned int y = 0; y < 11; y++) {
+        a(y, y) = true;
+        a(0, y) = true;
+        b(y, y) = true;
+    }
+
+    BitGrid both = a;
+    both &= b;
+    REQUIRE(both == b);
+
+    BitGrid either = b;
+    either |= a;
+    REQUIRE(either == a);
+
+    BitGrid difference = a;
+    difference.and_not(b);
+    BitGrid different = a;
+    different ^= b;
+    REQUIRE(difference == different);
+    REQUIRE(difference.count() == 10);
+    for (unsigned int y = 0; y < 11; y++) {
+        REQUIRE(difference(0, y) == (y != 0));
+    }
+}
+
+TEST_CASE("BitGrid shifts correct") {
+    BitGrid grid(5, 6);
+    grid(0, 0) = true;
+    grid(4, 2) = true;
+    grid(2, 5) = true;
+
+    BitGrid up = grid;
+    up.shift_up();
+    REQUIRE(up.count() == 2);
+    REQUIRE(up(4, 1));
+    REQUIRE(up(2, 4));
+
+    BitGrid down = grid;
+    down.shift_down();
+    REQUIRE(down.count() == 2);
+    REQUIRE(down(0, 1));
+    REQUIRE(down(4, 3));
+
+    BitGrid left = grid;
+    left.shift_left();
+    REQUIRE(left.count() == 2);
+    REQUIRE(left(3, 2));
+    REQUIRE(left(1, 5));
+
+    // Cells on the right edge must not wrap onto the next row
+    BitGrid right = grid;
+    right.shift_right();
+    REQUIRE(right.count() == 2);
+    REQUIRE(right(1, 0));
+    REQUIRE(right(3, 5));
+    REQUIRE(right.get_row(2) == 0);
+}
+
+TEST_CASE("BitGrid count and find_first correct") {
+    BitGrid grid(7, 9);
+    REQUIRE(grid.count() == 0);
+    REQUIRE(!grid.any());
+    REQUIRE(grid.find_first() == grid.size());
+
+    grid(5, 3) = true;
+    grid(2, 6) = true;
+    REQUIRE(grid.count() == 2);
+    REQUIRE(grid.any());
+    REQUIRE(grid.find_first() == 3 * 7 + 5);
+
+    grid.fill();
+    REQUIRE(grid.count() == 7 * 9);
+    grid.shift_right();
+    REQUIRE(grid.count() == 6 * 9);
+    grid.clear();
+    REQUIRE(!grid.any());
+}
+
+TEST_CASE("BitGrid whole grid operations match cell by cell results") {
+    std::mt19937 rng(1357);
+
+    // Cell reads never take the AVX2 paths, so a build with -mavx2 checks them against these
+    for (const auto& [w, h] : {std::pair{1u, 1u}, std::pair{7u, 3u}, std::pair{11u, 11u}, std::pair{19u, 8u}, std::pair{64u, 13u}}) {
+        BitGrid a(w, h);
+        BitGrid b(w, h);
+        for (unsigned int y = 0; y < h; y++) {
+            a.set_row(y, (uint64_t{rng()} << 32) | rng());
+            b.set_row(y, (uint64_t{rng()} << 32) | rng());
+        }
+
+        BitGrid both = a;
+        both &= b;
+        BitGrid either = a;
+        either |= b;
+        BitGrid different = a;
+        different ^= b;
+        BitGrid difference = a;
+        difference.and_not(b);
+        BitGrid left = a;
+        left.shift_left();
+        BitGrid right = a;
+        right.shift_right();
+
+        for (unsigned int y = 0; y < h; y++) {
+            for (unsigned int x = 0; x < w; x++) {
+                REQUIRE(both(x, y) == (a(x, y) && b(x, y)));
+                REQUIRE(either(x, y) == (a(x, y) || b(x, y)));
+                REQUIRE(different(x, y) == (a(x, y) != b(x, y)));
+                REQUIRE(difference(x, y) == (a(x, y) && !b(x, y)));
+                REQUIRE(left(x, y) == (x + 1 < w && a(x + 1, y)));
+                REQUIRE(right(x, y) == (x > 0 && a(x - 1, y)));
+            }
+
+            // No cell is set past the width of the grid
+            for (const BitGrid* grid : {&both, &either, &different, &difference, &left, &right}) {
+                REQUIRE((w == BitGrid::MAX_WIDTH || (grid->get_row(y) >> w) == 0));
+            }
+        }
+    }
+}
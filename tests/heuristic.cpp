@@ -0,0 +1,38 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../ai.hpp"
+#include "../bitboard.hpp"
+
+TEST_CASE("heuristic_evaluate gives equal shares without weights") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({5, 5}, 5, 40),
+    };
+    const Simulator::Ruleset ruleset{7, 7, 2, 1, 15, 100, true};
+    const Simulator::BitBoard board(Simulator::Board{snakes, Simulator::FoodGrid{Grid<bool>(7, 7), 0}, ruleset});
+
+    const AI::RewardArray weighted = AI::heuristic_evaluate(board, AI::HeuristicWeights{1.0f, 0.5f, 0.25f});
+    REQUIRE(weighted[0] != weighted[1]);
+
+    const AI::RewardArray unweighted = AI::heuristic_evaluate(board, AI::HeuristicWeights{0.0f, 0.0f, 0.0f});
+    REQUIRE(unweighted[0] == Approx(0.5f));
+    REQUIRE(unweighted[1] == Approx(0.5f));
+}
+
+TEST_CASE("seek_food_player finds food in a grid smaller than the board") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({1, 1}, 3),
+        Simulator::Snake({5, 5}, 3),
+    };
+
+    Grid<bool> cells(3, 3);
+    cells(1, 2) = true;
+    const Simulator::Ruleset ruleset{7, 7, 2, 1, 15, 100, true};
+    const Simulator::Board board{snakes, Simulator::FoodGrid{cells, 1}, ruleset};
+
+    Simulator::Rng rng(1);
+    REQUIRE(AI::seek_food_player(board, 0, rng) == Simulator::Direction::DOWN);
+    REQUIRE(AI::seek_food_player(board, 1, rng) != Simulator::Direction::DOWN);
+}
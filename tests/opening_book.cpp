@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../opening_book.hpp"
+
+namespace {
+
+    // Removed when the test case ends
+    struct TemporaryFile {
+        std::string path = "opening_book_test.bin";
+
+        ~TemporaryFile() {
+            std::remove(path.c_str());
+        }
+    };
+
+}
+
+TEST_CASE("OpeningBook finds the moves it was written with") {
+    using Simulator::Direction;
+
+    TemporaryFile file;
+    const std::vector<std::pair<uint64_t, Direction>> entries {
+        {42, Direction::LEFT},
+        {7, Direction::DOWN},
+        {UINT64_MAX, Direction::RIGHT},
+        {42, Direction::UP}, // Ignored, 42 is already in the book
+        {0, Direction::UP}
+    };
+    REQUIRE(AI::OpeningBook::write(file.path, entries));
+
+    AI::OpeningBook book(file.path);
+    REQUIRE(book.size() == 4);
+    REQUIRE(book.find(0) == Direction::UP);
+    REQUIRE(book.find(7) == Direction::DOWN);
+    REQUIRE(book.find(42) == Direction::LEFT);
+    REQUIRE(book.find(UINT64_MAX) == Direction::RIGHT);
+    REQUIRE_FALSE(book.find(8).has_value());
+    REQUIRE_FALSE(book.find(UINT64_MAX - 1).has_value());
+
+    // Moving the book keeps its mapping
+    const AI::OpeningBook moved(std::move(book));
+    REQUIRE(moved.find(42) == Direction::LEFT);
+}
+
+TEST_CASE("OpeningBook is empty if the file is not a book") {
+    TemporaryFile file;
+    REQUIRE(AI::OpeningBook(file.path).size() == 0);
+
+    {
+        std::ofstream stream(file.path, std::ios::binary);
+        stream << "not a book, but long enough to hold a header";
+    }
+    const AI::OpeningBook book(file.path);
+    REQUIRE(book.size() == 0);
+    REQUIRE_FALSE(book.find(0).has_value());
+}
+
+TEST_CASE("book_key does not depend on the index of the player") {
+    const Simulator::Snake s1({1, 2}, 3);
+    const Simulator::Snake s2({9, 4}, 3);
+    const Simulator::FoodGrid food = {Grid<bool>(11, 11), 0};
+
+    const Simulator::Board board{{s1, s2}, food};
+    const Simulator::Board swapped{{s2, s1}, food};
+
+    REQUIRE(AI::book_key(board, 1).hash == AI::book_key(swapped, 0).hash);
+    REQUIRE(AI::book_key(board, 1).symmetry == AI::book_key(swapped, 0).symmetry);
+    REQUIRE(AI::book_key(board, 0).hash != AI::book_key(board, 1).hash);
+}
+
+TEST_CASE("book_key shares a position with its rotations and reflections") {
+    using Simulator::Direction;
+    using Simulator::Position;
+
+    // Snake 0 moves left onto the food, and in each image onto the image of the food
+    const auto make_board = [](unsigned int t_symmetry) {
+        const auto image = [&](Position t_position) {
+            return Simulator::transform_position(t_symmetry, t_position, 11, 11);
+        };
+
+        Grid<bool> cells(11, 11);
+        const Position food = image({0, 1});
+        cells(food.x, food.y) = true;
+
+        const Simulator::Snake s1({image({3, 1}), image({2, 1}), image({1, 1})}, 50);
+        const Simulator::Snake s2({image({8, 9}), image({8, 8}), image({8, 7})}, 90);
+        return Simulator::Board{{s1, s2}, Simulator::FoodGrid{cells, 1}};
+    };
+
+    TemporaryFile file;
+    const AI::BookKey key = AI::book_key(make_board(Simulator::IDENTITY_SYMMETRY), 0);
+    REQUIRE(AI::OpeningBook::write(file.path, {{key.hash, Simulator::transform_direction(key.symmetry, Direction::LEFT)}}));
+    const AI::OpeningBook book(file.path);
+
+    for (unsigned int s = 0; s < Simulator::SYMMETRY_COUNT; s++) {
+        const AI::BookKey imageKey = AI::book_key(make_board(s), 0);
+        REQUIRE(imageKey.hash == key.hash);
+        REQUIRE(book.find(imageKey) == Simulator::transform_direction(s, Direction::LEFT));
+    }
+}
@@ -0,0 +1,40 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../ai.hpp"
+#include "../bitboard.hpp"
+#include "../server_logic.hpp"
+
+TEST_CASE("make_ruleset keeps the settings of the request") {
+    const Simulator::Ruleset ruleset = ServerLogic::make_ruleset(11, 7, 3, 2, 25);
+    REQUIRE(ruleset.w == 11);
+    REQUIRE(ruleset.h == 7);
+    REQUIRE(ruleset.noSnakes == 3);
+    REQUIRE(ruleset.minFood == 2);
+    REQUIRE(ruleset.foodSpawnChance == 25);
+    REQUIRE(ruleset.startingHealth == Simulator::DEFAULT_RULESET.startingHealth);
+    REQUIRE(ruleset.spawnFood);
+}
+
+TEST_CASE("Snakes survive eating on boards built like the server's") {
+    const std::vector<Simulator::Snake> snakes {
+        Simulator::Snake({3, 3}, 3, 1),
+        Simulator::Snake({8, 8}, 3),
+    };
+
+    Grid<bool> cells(11, 11);
+    cells(3, 2) = true;
+    const Simulator::Ruleset ruleset = ServerLogic::make_ruleset(11, 11, 2, 1, 15);
+    const Simulator::Board board{snakes, Simulator::FoodGrid{cells, 1}, ruleset};
+
+    Simulator::BitBoard bitBoard(board);
+    bitBoard.update({Simulator::Direction::UP, Simulator::Direction::UP});
+    REQUIRE(bitBoard.is_alive(0));
+    REQUIRE(bitBoard.get_health(0) == ruleset.startingHealth);
+
+    // With one health left the food is the only move that survives
+    AI::MCTSParameters params = AI::DEFAULT_PARAMETERS;
+    params.computeTime = 50;
+    REQUIRE(AI::mcts_suct_player(board, 0, params) == Simulator::Direction::UP);
+}
@@ -1,4 +1,6 @@
+#include <array>
 #include <unordered_map>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -85,3 +87,64 @@ TEST_CASE("Snake move correct") {
     REQUIRE(snake.get_health() == 96);
 }
 
+
+TEST_CASE("Snake get_body correct") {
+    const std::vector<Simulator::Position> body {{1, 1}, {1, 2}, {2, 2}};
+    const Simulator::Snake snake(body, 100);
+
+    REQUIRE(snake.get_body() == body);
+    REQUIRE(snake.get_tail() == Simulator::Position{1, 1});
+    REQUIRE(snake.get_segment(1) == Simulator::Position{1, 2});
+
+    std::vector<Simulator::Position> iterated;
+    for (const Simulator::Position& position : snake) {
+        iterated.push_back(position);
+    }
+    REQUIRE(iterated == body);
+}
+
+TEST_CASE("Snake move and pop_tail wrap around correct") {
+    Simulator::Snake snake({0, 0}, 3, 100);
+
+    // Walk in a loop many times longer than the buffer so the indices wrap
+    const std::array<Simulator::Direction, 4> loop {
+        Simulator::Direction::RIGHT,
+        Simulator::Direction::DOWN,
+        Simulator::Direction::LEFT,
+        Simulator::Direction::UP
+    };
+
+    std::vector<Simulator::Position> expected(3, Simulator::Position{0, 0});
+    for (unsigned int i = 0; i < 100; i++) {
+        const Simulator::Direction move = loop[i % loop.size()];
+        snake.move(move);
+        expected.push_back(Simulator::update_position(expected.back(), move));
+
+        if (i % 10 != 0) {
+            snake.pop_tail();
+            expected.erase(expected.begin());
+        }
+
+        REQUIRE(snake.get_length() == expected.size());
+        REQUIRE(snake.get_head() == expected.back());
+        REQUIRE(snake.get_tail() == expected.front());
+        REQUIRE(snake.get_body() == expected);
+    }
+}
+
+TEST_CASE("Snake reserve correct") {
+    Simulator::Snake s1({{1, 1}, {2, 1}, {3, 1}}, 100);
+    const Simulator::Snake s2 = s1;
+
+    s1.pop_tail();
+    s1.move(Simulator::Direction::RIGHT);
+    s1.set_health(100);
+
+    s1.reserve(121);
+    REQUIRE(s1.get_body() == std::vector<Simulator::Position>{{2, 1}, {3, 1}, {4, 1}});
+    REQUIRE(!(s1 == s2));
+
+    s1.reserve(4);
+    REQUIRE(s1.get_length() == 3);
+    REQUIRE(s1.get_head() == Simulator::Position{4, 1});
+}
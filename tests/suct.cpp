@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../ai.hpp"
+
+TEST_CASE("SUCT proves a forced win and stops searching") {
+    using Simulator::Position;
+
+    // Snake 1 is in the corner with a single cell to go to, and the longer
+    // snake 0 wins the head on collision there by moving up
+    const Simulator::Snake s0({Position{2, 4}, Position{1, 4}, Position{0, 4}, Position{0, 3}, Position{0, 2}});
+    const Simulator::Snake s1({Position{2, 0}, Position{1, 0}, Position{0, 0}});
+    const Simulator::Ruleset ruleset{7, 7, 2, 0, 0, 100, false};
+    const Simulator::Board board{{s0, s1}, Simulator::FoodGrid{Grid<bool>(7, 7), 0}, ruleset};
+
+    // The heads are two cells apart, so the endgame solver leaves it to the search
+    REQUIRE_FALSE(AI::endgame_player(board, 0).has_value());
+
+    AI::MCTSParameters params = AI::DEFAULT_PARAMETERS;
+    params.computeTime = 2000;
+    AI::SearchStats stats{};
+
+    const auto start = std::chrono::steady_clock::now();
+    const Simulator::Direction move = AI::mcts_suct_player(board, 0, params, &stats);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(move == Simulator::Direction::UP);
+    REQUIRE(stats.iterations > 0);
+    REQUIRE(stats.iterations < 100);
+    REQUIRE(elapsed < std::chrono::milliseconds(params.computeTime / 2));
+}
+
+TEST_CASE("SUCT proves a draw when its other move loses") {
+    using Simulator::Position;
+
+    // Moving right meets snake 1 head on, which is forced there, and both
+    // snakes of equal length die. Moving up enters a dead end and loses.
+    const Simulator::Snake s0({
+        Position{5, 1}, Position{4, 1}, Position{4, 2}, Position{3, 2}, Position{3, 1},
+        Position{2, 1}, Position{1, 1}, Position{1, 2}, Position{1, 3}, Position{2, 3}
+    });
+    const Simulator::Snake s1({
+        Position{0, 4}, Position{1, 4}, Position{2, 4}, Position{2, 5}, Position{3, 5},
+        Position{4, 5}, Position{4, 4}, Position{5, 4}, Position{5, 3}, Position{4, 3}
+    });
+    const Simulator::Ruleset ruleset{7, 7, 2, 0, 0, 100, false};
+    const Simulator::Board board{{s0, s1}, Simulator::FoodGrid{Grid<bool>(7, 7), 0}, ruleset};
+
+    REQUIRE_FALSE(AI::endgame_player(board, 0).has_value());
+
+    AI::MCTSParameters params = AI::DEFAULT_PARAMETERS;
+    params.computeTime = 2000;
+    AI::SearchStats stats{};
+
+    const auto start = std::chrono::steady_clock::now();
+    const Simulator::Direction move = AI::mcts_suct_player(board, 0, params, &stats);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(move == Simulator::Direction::RIGHT);
+    REQUIRE(stats.iterations > 0);
+    REQUIRE(stats.iterations < 100);
+    REQUIRE(elapsed < std::chrono::milliseconds(params.computeTime / 2));
+}
+
+TEST_CASE("Tree parallel SUCT reuses the shared tree of a SearchTree") {
+    const Simulator::Snake s0(Simulator::Position{1, 1}, 3);
+    const Simulator::Snake s1(Simulator::Position{9, 9}, 3);
+    const Simulator::Board board{{s0, s1}, Simulator::FoodGrid{Grid<bool>(11, 11), 0}};
+
+    AI::MCTSParameters params = AI::DEFAULT_PARAMETERS;
+    params.computeTime = 50;
+    params.threadCount = 2;
+
+    // The second search empties the tree the first one left behind
+    AI::SearchTree tree;
+    for (unsigned int search = 0; search < 2; search++) {
+        AI::SearchStats stats{};
+        const Simulator::Direction move = AI::mcts_tree_suct_player(tree, board, 0, params, &stats);
+        const std::vector<Simulator::Direction> safeMoves = AI::get_safe_moves(board, 0);
+        REQUIRE(std::find(safeMoves.begin(), safeMoves.end(), move) != safeMoves.end());
+        REQUIRE(stats.iterations > 0);
+        REQUIRE(stats.nodes > 0);
+    }
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+
+#include "../transposition.hpp"
+
+namespace {
+
+    struct TestEntry {
+        unsigned int value = 0;
+
+        [[nodiscard]] unsigned int weight() const {
+            return value;
+        }
+    };
+
+    // Smaller than a bucket, so every key shares the single bucket of the table
+    using TestTable = AI::TranspositionTable<TestEntry>;
+    constexpr size_t SINGLE_BUCKET = 0;
+
+}
+
+TEST_CASE("TranspositionTable stores and finds entries") {
+    TestTable table(SINGLE_BUCKET);
+    REQUIRE(table.get_stats().capacity == TestTable::BUCKET_SIZE);
+
+    REQUIRE(table.probe(7) == nullptr);
+    table.store(7).value = 3;
+    table.store(9).value = 5;
+
+    REQUIRE(table.probe(7) != nullptr);
+    REQUIRE(table.probe(7)->value == 3);
+    REQUIRE(table.store(9).value == 5);
+
+    const AI::TableStats stats = table.get_stats();
+    REQUIRE(stats.used == 2);
+    REQUIRE(stats.probes == 3);
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.collisions == 0);
+    REQUIRE(stats.get_occupancy() == Approx(0.5));
+
+    table.clear();
+    REQUIRE(table.probe(7) == nullptr);
+    REQUIRE(table.get_stats().used == 0);
+}
+
+TEST_CASE("TranspositionTable replaces the entry of least weight") {
+    TestTable table(SINGLE_BUCKET);
+    for (unsigned int key = 1; key <= TestTable::BUCKET_SIZE; key++) {
+        table.store(key).value = 10 * key;
+    }
+
+    table.store(100).value = 1;
+    REQUIRE(table.probe(1) == nullptr);
+    REQUIRE(table.probe(2) != nullptr);
+    REQUIRE(table.probe(100) != nullptr);
+    REQUIRE(table.get_stats().collisions == 1);
+    REQUIRE(table.get_stats().used == TestTable::BUCKET_SIZE);
+
+    // A new entry starts with no weight, so it is the next to go
+    table.store(101);
+    REQUIRE(table.probe(100) == nullptr);
+    REQUIRE(table.probe(101)->value == 0);
+}
+
+TEST_CASE("TranspositionTable replaces entries of earlier searches first") {
+    TestTable table(SINGLE_BUCKET);
+    for (unsigned int key = 1; key <= TestTable::BUCKET_SIZE; key++) {
+        table.store(key).value = 10 * key;
+    }
+
+    table.new_search();
+    REQUIRE(table.get_stats().probes == 0);
+
+    // Entries used again carry over to the new search, however light
+    REQUIRE(table.probe(1) != nullptr);
+    table.store(100).value = 1;
+    table.store(101).value = 1;
+
+    REQUIRE(table.probe(1) != nullptr);
+    REQUIRE(table.probe(2) == nullptr);
+    REQUIRE(table.probe(3) == nullptr);
+    REQUIRE(table.probe(4) != nullptr);
+    REQUIRE(table.get_stats().collisions == 0);
+}
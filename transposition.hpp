@@ -0,0 +1,160 @@
+#ifndef TRANSPOSITION_INCLUDED
+#define TRANSPOSITION_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AI {
+
+    // Probes, hits and collisions are counted from the start of the current search
+    struct TableStats {
+        uint64_t capacity; // Entries the table can hold
+        uint64_t used; // Entries holding a position, from any search
+        uint64_t probes;
+        uint64_t hits;
+        uint64_t collisions; // Positions stored over another position of the same search
+
+        [[nodiscard]] double get_occupancy() const {
+            return (capacity != 0) ? static_cast<double>(used) / static_cast<double>(capacity) : 0.0;
+        }
+    };
+
+    // Fixed size table of search results keyed by 64 bit position hashes, so
+    // memory use does not depend on how long a search runs. A position can
+    // only be held by the BUCKET_SIZE entries of its bucket. When they are
+    // all taken an entry from an earlier search is replaced first, otherwise
+    // the entry of least weight, which keeps the entries holding the most
+    // work, be it search depth or visits.
+    // Entry must be default constructible and have `unsigned int weight() const`.
+    template <class Entry>
+    class TranspositionTable {
+    public:
+        static constexpr unsigned int BUCKET_SIZE = 4;
+
+        // Holds the largest power of two number of buckets that fits in t_megabytes, at least one
+        explicit TranspositionTable(size_t t_megabytes)
+            : m_buckets(bucket_count(t_megabytes))
+            , m_mask(m_buckets.size() - 1)
+            , m_generation(1)
+            , m_stats{m_buckets.size() * BUCKET_SIZE, 0, 0, 0, 0}
+        {
+            ;
+        }
+
+        // Starts a new search, entries of earlier searches are kept until they are replaced
+        void new_search() {
+            // Generation 0 marks empty slots
+            m_generation = (m_generation == UINT8_MAX) ? 1 : m_generation + 1;
+            m_stats = TableStats{m_stats.capacity, m_stats.used, 0, 0, 0};
+        }
+
+        // Returns the entry of t_key, or null if it is not in the table.
+        // Finding an entry carries it over to the current search.
+        Entry* probe(uint64_t t_key) {
+            m_stats.probes++;
+
+            Slot* slot = find(t_key);
+            if (slot == nullptr) {
+                return nullptr;
+            }
+
+            m_stats.hits++;
+            slot->generation = m_generation;
+            return &slot->entry;
+        }
+
+        // Returns the entry of t_key, a value initialised one if t_key was not in the table.
+        // Storing may replace any other entry of the bucket, so pointers from probe can go stale.
+        Entry& store(uint64_t t_key) {
+            Slot* slot = find(t_key);
+            if (slot != nullptr) {
+                slot->generation = m_generation;
+                return slot->entry;
+            }
+
+            Bucket& bucket = m_buckets[t_key & m_mask];
+            Slot* victim = &bucket.slots[0];
+            for (Slot& candidate : bucket.slots) {
+                if (replaces(candidate, *victim)) {
+                    victim = &candidate;
+                }
+            }
+
+            if (victim->generation == 0) {
+                m_stats.used++;
+            }
+            else if (victim->generation == m_generation) {
+                m_stats.collisions++;
+            }
+
+            victim->key = t_key;
+            victim->generation = m_generation;
+            victim->entry = Entry{};
+            return victim->entry;
+        }
+
+        void clear() {
+            std::fill(m_buckets.begin(), m_buckets.end(), Bucket{});
+            m_stats = TableStats{m_buckets.size() * BUCKET_SIZE, 0, 0, 0, 0};
+        }
+
+        [[nodiscard]] TableStats get_stats() const {
+            return m_stats;
+        }
+    private:
+        struct Slot {
+            uint64_t key = 0;
+            uint8_t generation = 0; // Search that last used the slot, 0 if it is empty
+            Entry entry{};
+        };
+
+        struct Bucket {
+            std::array<Slot, BUCKET_SIZE> slots{};
+        };
+
+        static size_t bucket_count(size_t t_megabytes) {
+            const size_t fitting = std::max<size_t>((t_megabytes << 20) / sizeof(Bucket), 1);
+
+            size_t result = 1;
+            while (result * 2 <= fitting) {
+                result *= 2;
+            }
+            return result;
+        }
+
+        Slot* find(uint64_t t_key) {
+            Bucket& bucket = m_buckets[t_key & m_mask];
+            for (Slot& slot : bucket.slots) {
+                if (slot.generation != 0 && slot.key == t_key) {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+
+        // True if t_candidate should be replaced before t_current
+        bool replaces(const Slot& t_candidate, const Slot& t_current) const {
+            if (t_current.generation == 0) return false;
+            if (t_candidate.generation == 0) return true;
+
+            const bool candidateStale = t_candidate.generation != m_generation;
+            const bool currentStale = t_current.generation != m_generation;
+            if (candidateStale != currentStale) {
+                return candidateStale;
+            }
+
+            return t_candidate.entry.weight() < t_current.entry.weight();
+        }
+
+        std::vector<Bucket> m_buckets;
+        size_t m_mask;
+        uint8_t m_generation;
+        TableStats m_stats;
+    };
+
+}
+
+#endif
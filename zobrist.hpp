@@ -0,0 +1,117 @@
+#ifndef ZOBRIST_INCLUDED
+#define ZOBRIST_INCLUDED
+
+#include <array>
+#include <cstdint>
+
+#include "simulator.hpp"
+
+// Zobrist keys for incrementally hashing boards. Keys are generated with
+// splitmix64 from a fixed seed, so hashes are identical between runs and
+// between builds. Boards or snake counts too large for the tables fall back
+// to generating the key on the fly.
+namespace Simulator {
+
+    // Role of a body segment in its snake, the direction roles give the direction to the next segment towards the head
+    enum class SegmentRole {
+        UP,
+        DOWN,
+        LEFT,
+        RIGHT,
+        HEAD
+    };
+
+    constexpr SegmentRole direction_to_role(Direction t_direction) {
+        return static_cast<SegmentRole>(t_direction);
+    }
+
+    namespace Zobrist {
+
+        constexpr unsigned int TABLE_CELLS = MAX_BOARD_CELLS;
+        constexpr unsigned int TABLE_SNAKES = MAX_SNAKES;
+        constexpr unsigned int TABLE_ROLES = 5;
+        constexpr unsigned int TABLE_HEALTH = 128;
+        constexpr unsigned int TABLE_LENGTH = 512;
+        constexpr unsigned int TABLE_PLIES = MAX_SNAKES;
+
+        enum Component : uint64_t {
+            SEGMENT = 1,
+            FOOD,
+            HEALTH,
+            LENGTH,
+            MOVE
+        };
+
+        constexpr uint64_t mix(uint64_t t_x) {
+            uint64_t z = t_x + 0x9e3779b97f4a7c15ull;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        constexpr uint64_t generate(Component t_component, uint64_t t_index) {
+            return mix(mix(0x5eed0f5a4e5ull ^ t_component) ^ t_index);
+        }
+
+        template <size_t N>
+        constexpr std::array<uint64_t, N> generate_table(Component t_component) {
+            std::array<uint64_t, N> result{};
+            for (size_t i = 0; i < N; i++) {
+                result[i] = generate(t_component, i);
+            }
+            return result;
+        }
+
+        struct Tables {
+            std::array<uint64_t, TABLE_CELLS * TABLE_SNAKES * TABLE_ROLES> segment;
+            std::array<uint64_t, TABLE_CELLS> food;
+            std::array<uint64_t, TABLE_SNAKES * TABLE_HEALTH> health;
+            std::array<uint64_t, TABLE_SNAKES * TABLE_LENGTH> length;
+            std::array<uint64_t, TABLE_PLIES * 4> move;
+        };
+
+        inline constexpr Tables TABLES {
+            generate_table<TABLE_CELLS * TABLE_SNAKES * TABLE_ROLES>(SEGMENT),
+            generate_table<TABLE_CELLS>(FOOD),
+            generate_table<TABLE_SNAKES * TABLE_HEALTH>(HEALTH),
+            generate_table<TABLE_SNAKES * TABLE_LENGTH>(LENGTH),
+            generate_table<TABLE_PLIES * 4>(MOVE)
+        };
+
+        inline uint64_t segment(unsigned int t_cell, unsigned int t_snake, SegmentRole t_role) {
+            const uint64_t index = (static_cast<uint64_t>(t_role) * TABLE_SNAKES + t_snake) * TABLE_CELLS + t_cell;
+            if (t_cell < TABLE_CELLS && t_snake < TABLE_SNAKES) {
+                return TABLES.segment[index];
+            }
+            return generate(SEGMENT, (uint64_t{t_snake} << 40) | (static_cast<uint64_t>(t_role) << 32) | t_cell);
+        }
+
+        inline uint64_t food(unsigned int t_cell) {
+            return (t_cell < TABLE_CELLS) ? TABLES.food[t_cell] : generate(FOOD, t_cell);
+        }
+
+        inline uint64_t health(unsigned int t_snake, int t_health) {
+            if (t_snake < TABLE_SNAKES && t_health >= 0 && t_health < static_cast<int>(TABLE_HEALTH)) {
+                return TABLES.health[t_snake * TABLE_HEALTH + t_health];
+            }
+            return generate(HEALTH, (uint64_t{t_snake} << 32) | static_cast<uint32_t>(t_health));
+        }
+
+        inline uint64_t length(unsigned int t_snake, unsigned int t_length) {
+            if (t_snake < TABLE_SNAKES && t_length < TABLE_LENGTH) {
+                return TABLES.length[t_snake * TABLE_LENGTH + t_length];
+            }
+            return generate(LENGTH, (uint64_t{t_snake} << 32) | t_length);
+        }
+
+        // Key for a move that has been chosen but not yet played, t_ply is the position of the player in the turn order
+        inline uint64_t move(unsigned int t_ply, Direction t_direction) {
+            const uint64_t index = uint64_t{t_ply} * 4 + static_cast<uint64_t>(t_direction);
+            return (t_ply < TABLE_PLIES) ? TABLES.move[index] : generate(MOVE, index);
+        }
+
+    }
+
+}
+
+#endif